@@ -0,0 +1,95 @@
+# Compile time benchmark
+#
+# Generates UNITS translation units that each convert TYPES user types
+# (sb_append hooks, to_string, operator<<, and conversion to std::string)
+# with add() and make_string(), compiles them one after the other,
+# and reports the compile time and the size of the object files.
+#
+# Usage:
+#   cmake [-DHEADER=<path/to/string_builder.hpp>] [-DUNITS=20] [-DTYPES=40]
+#         [-DCXX=c++] [-DCXX_FLAGS="-std=c++17 -O2"] [-DWORK_DIR=<dir>] -P compile_time.cmake
+#
+# To compare two versions of the header, run it once per version, e.g. with
+# `git show <commit>:src/string_builder.hpp > old.hpp` and -DHEADER=old.hpp.
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT HEADER)
+    set(HEADER "${CMAKE_CURRENT_LIST_DIR}/../src/string_builder.hpp")
+endif()
+if(NOT UNITS)
+    set(UNITS 20)
+endif()
+if(NOT TYPES)
+    set(TYPES 40)
+endif()
+if(NOT CXX)
+    set(CXX "c++")
+endif()
+if(NOT CXX_FLAGS)
+    set(CXX_FLAGS "-std=c++17 -O2")
+endif()
+if(NOT WORK_DIR)
+    set(WORK_DIR "${CMAKE_CURRENT_BINARY_DIR}/compile_time")
+endif()
+separate_arguments(flags UNIX_COMMAND "${CXX_FLAGS}")
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/include")
+configure_file("${HEADER}" "${WORK_DIR}/include/string_builder.hpp" COPYONLY)
+
+# user types, one of four kinds each
+set(types "#include <ostream>\n#include <string>\n#include <string_builder.hpp>\n\nnamespace user\n{\n")
+math(EXPR last_type "${TYPES} - 1")
+foreach(i RANGE ${last_type})
+    math(EXPR kind "${i} % 4")
+    if(kind EQUAL 0)
+        string(APPEND types "struct type_${i} { int value{${i}}; };\n"
+               "inline void sb_append(bosswestfalen::sink& out, type_${i} const& x) { out.append(\"type_${i}:\"); bosswestfalen::append_to(out, x.value); }\n")
+    elseif(kind EQUAL 1)
+        string(APPEND types "struct type_${i} {};\n"
+               "inline std::string to_string(type_${i} const&) { return \"type_${i}\"; }\n")
+    elseif(kind EQUAL 2)
+        string(APPEND types "struct type_${i} {};\n"
+               "inline std::ostream& operator<<(std::ostream& stream, type_${i} const&) { return stream << \"type_${i}\"; }\n")
+    else()
+        string(APPEND types "struct type_${i} { operator std::string() const { return \"type_${i}\"; } };\n")
+    endif()
+endforeach()
+string(APPEND types "}\n")
+file(WRITE "${WORK_DIR}/include/types.hpp" "${types}")
+
+# translation units converting every type
+math(EXPR last_unit "${UNITS} - 1")
+foreach(unit RANGE ${last_unit})
+    set(source "#include <string>\n#include \"types.hpp\"\n\nstd::string unit_${unit}()\n{\n    bosswestfalen::string_builder sb;\n    std::string result;\n")
+    foreach(i RANGE ${last_type})
+        string(APPEND source "    sb.add(user::type_${i}{});\n    result += bosswestfalen::make_string(user::type_${i}{});\n")
+    endforeach()
+    string(APPEND source "    sb.add(${unit});\n    return result + sb.build();\n}\n")
+    file(WRITE "${WORK_DIR}/unit_${unit}.cpp" "${source}")
+endforeach()
+
+# compile and measure
+set(total_microseconds 0)
+set(total_bytes 0)
+foreach(unit RANGE ${last_unit})
+    string(TIMESTAMP start "%s%f")
+    execute_process(COMMAND "${CXX}" ${flags} -I "${WORK_DIR}/include" -c "${WORK_DIR}/unit_${unit}.cpp" -o "${WORK_DIR}/unit_${unit}.o"
+                    RESULT_VARIABLE result)
+    string(TIMESTAMP stop "%s%f")
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "compiling unit_${unit}.cpp failed")
+    endif()
+    math(EXPR total_microseconds "${total_microseconds} + ${stop} - ${start}")
+    file(SIZE "${WORK_DIR}/unit_${unit}.o" bytes)
+    math(EXPR total_bytes "${total_bytes} + ${bytes}")
+endforeach()
+
+math(EXPR total_milliseconds "${total_microseconds} / 1000")
+math(EXPR unit_milliseconds "${total_milliseconds} / ${UNITS}")
+math(EXPR unit_bytes "${total_bytes} / ${UNITS}")
+message("header:       ${HEADER}")
+message("units, types: ${UNITS}, ${TYPES}")
+message("compile time: ${total_milliseconds} ms (${unit_milliseconds} ms per unit)")
+message("object size:  ${total_bytes} bytes (${unit_bytes} bytes per unit)")
@@ -0,0 +1,125 @@
+#ifndef BOSSWESTFALEN_BENCH_BENCH_HPP
+#define BOSSWESTFALEN_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// Minimal benchmark harness
+namespace bench
+{
+
+/// Result of a single benchmark.
+struct result final
+{
+    /// Name of the group of related benchmarks.
+    std::string group;
+    /// Name of the benchmark.
+    std::string name;
+    /// Number of measured calls.
+    std::size_t iterations;
+    /// Time per call.
+    double ns_per_op;
+    /// Calls of `operator new` per call.
+    double allocations_per_op;
+    /// Bytes requested from `operator new` per call.
+    double bytes_per_op;
+};
+
+/// Number of calls of the global `operator new` so far (see main.cpp).
+std::size_t allocation_count() noexcept;
+
+/// Number of bytes requested from the global `operator new` so far (see main.cpp).
+std::size_t allocated_bytes() noexcept;
+
+/// Whether benchmarks of `group` are selected on the command line (see main.cpp).
+bool selected(std::string const& group);
+
+/// Record a result (see main.cpp).
+void report(result const& measurement);
+
+/// Prevent the compiler from optimizing away the computation of `value`.
+template <typename T>
+void do_not_optimize(T const& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// \brief Call `function` repeatedly and report time and allocations per call.
+///
+/// After one warm-up call, the number of iterations is doubled until the
+/// measurement takes at least 100 ms.
+///
+/// \param group Name of the group of related benchmarks.
+/// \param name Name of the benchmark.
+/// \param function The code to measure.
+template <typename Function>
+void run(std::string const& group, std::string const& name, Function&& function)
+{
+    if (not selected(group))
+    {
+        return;
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto const minimal_duration = std::chrono::milliseconds{100};
+
+    function();
+    std::size_t iterations{1};
+    for (;;)
+    {
+        auto const allocations = allocation_count();
+        auto const bytes = allocated_bytes();
+        auto const start = clock::now();
+        for (std::size_t i{0}; i < iterations; ++i)
+        {
+            function();
+        }
+        auto const elapsed = clock::now() - start;
+        if (elapsed >= minimal_duration)
+        {
+            auto const n = static_cast<double>(iterations);
+            report(result{group, name, iterations,
+                          std::chrono::duration<double, std::nano>{elapsed}.count() / n,
+                          static_cast<double>(allocation_count() - allocations) / n,
+                          static_cast<double>(allocated_bytes() - bytes) / n});
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+/// make_string for every conversion path against std::to_string and std::ostringstream
+void conversion();
+
+/// integers and floating point values against std::to_string, snprintf, and std::ostringstream
+void numbers();
+
+/// json_escaped, html_escaped, and csv_escaped against escaping byte by byte
+void escape();
+
+/// add() with different fragment sizes and counts, build() latency
+void add_build();
+
+/// a new builder per request against clear() and string_builder_pool
+void reuse();
+
+/// hash(), equals(), starts_with(), and find() against the same on the result of build()
+void segments();
+
+/// nested builders combined with add(std::move(inner)) against add(inner.build())
+void splice();
+
+/// concat() and format() against string_builder and operator+
+void concat();
+
+/// build_parallel() with 1 to N threads, build_to_mapping() against build() and write()
+void parallel_build();
+
+/// concurrent_string_builder against a string_builder protected by a mutex
+void concurrent();
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include <deque>
+#include <sstream>
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+/// add `count` copies of `fragment` to a new builder of type `Builder` and build
+template <typename Builder>
+void add_and_build(std::string const& fragment, int const count)
+{
+    Builder sb;
+    for (int i{0}; i < count; ++i)
+    {
+        sb.add(fragment);
+    }
+    do_not_optimize(sb.build());
+}
+
+}
+
+void add_build()
+{
+    for (auto const fragment_size : {4, 32, 256, 4096})
+    {
+        for (auto const count : {8, 128, 4096})
+        {
+            std::string const fragment(static_cast<std::size_t>(fragment_size), 'x');
+            auto const suffix = " size=" + std::to_string(fragment_size) + " count=" + std::to_string(count);
+
+            run("add", "string_builder" + suffix, [&]
+            {
+                add_and_build<bosswestfalen::string_builder>(fragment, count);
+            });
+            run("add", "basic_string_builder<std::deque>" + suffix, [&]
+            {
+                add_and_build<bosswestfalen::basic_string_builder<std::deque>>(fragment, count);
+            });
+            run("add", "std::ostringstream" + suffix, [&]
+            {
+                std::ostringstream stream;
+                for (int i{0}; i < count; ++i)
+                {
+                    stream << fragment;
+                }
+                do_not_optimize(stream.str());
+            });
+            run("add", "std::string::operator+=" + suffix, [&]
+            {
+                std::string result;
+                for (int i{0}; i < count; ++i)
+                {
+                    result += fragment;
+                }
+                do_not_optimize(result);
+            });
+            run("add", "std::string reserve+append" + suffix, [&]
+            {
+                std::string result;
+                result.reserve(fragment.size() * static_cast<std::size_t>(count));
+                for (int i{0}; i < count; ++i)
+                {
+                    result.append(fragment);
+                }
+                do_not_optimize(result);
+            });
+        }
+    }
+
+    for (auto const count : {8, 128, 4096, 65536})
+    {
+        bosswestfalen::string_builder sb;
+        bosswestfalen::basic_string_builder<std::deque> deque_sb;
+        for (int i{0}; i < count; ++i)
+        {
+            sb.add(i);
+            deque_sb.add(i);
+        }
+        auto const suffix = " count=" + std::to_string(count);
+
+        run("build", "string_builder::build()" + suffix, [&]
+        {
+            do_not_optimize(sb.build());
+        });
+        run("build", "basic_string_builder<std::deque>::build()" + suffix, [&]
+        {
+            do_not_optimize(deque_sb.build());
+        });
+        std::string target;
+        run("build", "string_builder::build_into()" + suffix, [&]
+        {
+            sb.build_into(target);
+            do_not_optimize(target);
+        });
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace
+{
+
+constexpr char message_pattern[]{"user={} action={} ms={}"};
+
+}
+
+namespace bench
+{
+
+void concat()
+{
+    std::string const name{"some_user_name"};
+    int const id{12345};
+    long const latency{987};
+
+    run("concat", "bosswestfalen::concat", [&]
+    {
+        do_not_optimize(bosswestfalen::concat("user=", id, " action=", name, " ms=", latency));
+    });
+
+    run("concat", "bosswestfalen::format<pattern>", [&]
+    {
+        do_not_optimize(bosswestfalen::format<message_pattern>(id, name, latency));
+    });
+
+    run("concat", "string_builder::add(args...)", [&]
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("user=", id, " action=", name, " ms=", latency);
+        do_not_optimize(sb.build());
+    });
+
+    run("concat", "string_builder::add per value", [&]
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("user=");
+        sb.add(id);
+        sb.add(" action=");
+        sb.add(name);
+        sb.add(" ms=");
+        sb.add(latency);
+        do_not_optimize(sb.build());
+    });
+
+    run("concat", "string_builder<std::deque>::add", [&]
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        sb.add("user=");
+        sb.add(id);
+        sb.add(" action=");
+        sb.add(name);
+        sb.add(" ms=");
+        sb.add(latency);
+        do_not_optimize(sb.build());
+    });
+
+    run("concat", "operator+ chain", [&]
+    {
+        do_not_optimize("user=" + std::to_string(id) + " action=" + name + " ms=" + std::to_string(latency));
+    });
+}
+
+}
@@ -0,0 +1,70 @@
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+/// run `function(thread index)` on `thread_count` threads and wait for them
+template <typename Function>
+void on_threads(unsigned const thread_count, Function const& function)
+{
+    std::vector<std::thread> threads;
+    for (unsigned t{0}; t < thread_count; ++t)
+    {
+        threads.emplace_back(function, t);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+}
+
+void concurrent()
+{
+    constexpr int values_per_thread{10000};
+    auto const hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned threads{1}; threads <= 2 * hardware; threads *= 2)
+    {
+        auto const suffix = "(" + std::to_string(threads) + " threads)";
+
+        run("concurrent", "concurrent_string_builder " + suffix, [&]
+        {
+            bosswestfalen::concurrent_string_builder sb;
+            on_threads(threads, [&sb](unsigned const t)
+            {
+                for (int i{0}; i < values_per_thread; ++i)
+                {
+                    sb.add(t, ":", i, ";");
+                }
+            });
+            do_not_optimize(sb.build());
+        });
+
+        run("concurrent", "mutex + string_builder " + suffix, [&]
+        {
+            bosswestfalen::string_builder sb;
+            std::mutex mutex;
+            on_threads(threads, [&sb, &mutex](unsigned const t)
+            {
+                for (int i{0}; i < values_per_thread; ++i)
+                {
+                    std::lock_guard<std::mutex> const lock{mutex};
+                    sb.add(t, ":", i, ";");
+                }
+            });
+            do_not_optimize(sb.build());
+        });
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace
+{
+
+/// converted with static_cast<std::string>
+struct with_operator_string final
+{
+    operator std::string() const
+    {
+        return "operator_string";
+    }
+};
+
+/// converted with to_string
+struct with_to_string final
+{
+    int value;
+};
+
+std::string to_string(with_to_string const& x)
+{
+    return "to_string:" + std::to_string(x.value);
+}
+
+/// converted with operator<<
+struct with_stream_operator final
+{
+    int value;
+};
+
+std::ostream& operator<<(std::ostream& stream, with_stream_operator const& x)
+{
+    return stream << "stream:" << x.value;
+}
+
+/// converted with sb_append
+struct with_sb_append final
+{
+    int value;
+};
+
+void sb_append(bosswestfalen::sink& out, with_sb_append const& x)
+{
+    out.append("sb_append:");
+    bosswestfalen::append_to(out, x.value);
+}
+
+}
+
+namespace bench
+{
+
+void conversion()
+{
+    int const integer{1234567};
+    double const floating{3.14159};
+    std::string const text{"a string of some length"};
+
+    run("conversion", "make_string(int)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(integer));
+    });
+    run("conversion", "std::to_string(int)", [&]
+    {
+        do_not_optimize(std::to_string(integer));
+    });
+    run("conversion", "make_string(double)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(floating));
+    });
+    run("conversion", "std::to_string(double)", [&]
+    {
+        do_not_optimize(std::to_string(floating));
+    });
+    run("conversion", "make_string(std::string)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(text));
+    });
+    run("conversion", "make_string(operator std::string)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(with_operator_string{}));
+    });
+    run("conversion", "make_string(to_string)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(with_to_string{42}));
+    });
+    run("conversion", "make_string(operator<<)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(with_stream_operator{42}));
+    });
+    run("conversion", "make_string(sb_append)", [&]
+    {
+        do_not_optimize(bosswestfalen::make_string(with_sb_append{42}));
+    });
+    run("conversion", "std::ostringstream << int", [&]
+    {
+        std::ostringstream stream;
+        stream << integer;
+        do_not_optimize(stream.str());
+    });
+}
+
+}
@@ -0,0 +1,111 @@
+#include <string>
+#include <vector>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace
+{
+
+/// JSON-like values: mostly plain text, some with quotes, backslashes, or line breaks.
+std::vector<std::string> make_values(std::size_t const count)
+{
+    std::vector<std::string> values;
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        std::string value{"user " + std::to_string(i) + " visited /products/item-" + std::to_string(i * 31 % 997)};
+        if (i % 8 == 0)
+        {
+            value += " and said \"great\"\n";
+        }
+        if (i % 16 == 0)
+        {
+            value += " C:\\temp\\file.txt";
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+/// Escape `text` for JSON one character at a time (what callers did before `json_escaped`).
+void escape_bytewise(std::string& result, std::string const& text)
+{
+    for (auto const character : text)
+    {
+        switch (character)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                result += character;
+        }
+    }
+}
+
+}
+
+namespace bench
+{
+
+void escape()
+{
+    auto const values = make_values(1000);
+    auto const suffix = " x" + std::to_string(values.size());
+
+    run("escape", "string_builder add(json_escaped(string))" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const& value : values)
+        {
+            sb.add(bosswestfalen::json_escaped(value));
+        }
+        do_not_optimize(sb.build());
+    });
+    run("escape", "string_builder add(string) escaped bytewise" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const& value : values)
+        {
+            std::string escaped;
+            escape_bytewise(escaped, value);
+            sb.add(std::move(escaped));
+        }
+        do_not_optimize(sb.build());
+    });
+    run("escape", "std::string escaped bytewise" + suffix, [&]
+    {
+        std::string result;
+        for (auto const& value : values)
+        {
+            escape_bytewise(result, value);
+        }
+        do_not_optimize(result);
+    });
+
+    run("escape", "string_builder add(html_escaped(string))" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const& value : values)
+        {
+            sb.add(bosswestfalen::html_escaped(value));
+        }
+        do_not_optimize(sb.build());
+    });
+    run("escape", "string_builder add(csv_escaped(string))" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const& value : values)
+        {
+            sb.add(bosswestfalen::csv_escaped(value));
+        }
+        do_not_optimize(sb.build());
+    });
+}
+
+}
@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace
+{
+
+/// Telemetry-like values: counters and measurements.
+struct sample final
+{
+    std::vector<long long> integers;
+    std::vector<double> doubles;
+};
+
+sample make_sample(std::size_t const count)
+{
+    sample values;
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        values.integers.push_back(static_cast<long long>(i * 7919 % 1000003) - 5000);
+        values.doubles.push_back(static_cast<double>(i) * 0.731 + 1.0 / static_cast<double>(i + 3));
+    }
+    return values;
+}
+
+}
+
+namespace bench
+{
+
+void numbers()
+{
+    auto const values = make_sample(1000);
+    auto const suffix = " x" + std::to_string(values.doubles.size());
+
+    run("numbers", "string_builder add(long long)" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const value : values.integers)
+        {
+            sb.add(value);
+        }
+        do_not_optimize(sb.build());
+    });
+    run("numbers", "std::string += std::to_string(long long)" + suffix, [&]
+    {
+        std::string result;
+        for (auto const value : values.integers)
+        {
+            result += std::to_string(value);
+        }
+        do_not_optimize(result);
+    });
+    run("numbers", "std::ostringstream << long long" + suffix, [&]
+    {
+        std::ostringstream stream;
+        for (auto const value : values.integers)
+        {
+            stream << value;
+        }
+        do_not_optimize(stream.str());
+    });
+
+    run("numbers", "string_builder add(double) shortest" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const value : values.doubles)
+        {
+            sb.add(value);
+        }
+        do_not_optimize(sb.build());
+    });
+    run("numbers", "std::string += std::to_string(double)" + suffix, [&]
+    {
+        std::string result;
+        for (auto const value : values.doubles)
+        {
+            result += std::to_string(value);
+        }
+        do_not_optimize(result);
+    });
+    run("numbers", "std::ostringstream << setprecision(17) << double" + suffix, [&]
+    {
+        std::ostringstream stream;
+        stream.precision(17);
+        for (auto const value : values.doubles)
+        {
+            stream << value;
+        }
+        do_not_optimize(stream.str());
+    });
+
+    run("numbers", "string_builder add(fixed(double, 3))" + suffix, [&]
+    {
+        bosswestfalen::string_builder sb;
+        for (auto const value : values.doubles)
+        {
+            sb.add(bosswestfalen::fixed(value, 3));
+        }
+        do_not_optimize(sb.build());
+    });
+    run("numbers", "std::string += snprintf(\"%.3f\")" + suffix, [&]
+    {
+        std::string result;
+        char buffer[64];
+        for (auto const value : values.doubles)
+        {
+            auto const length = std::snprintf(buffer, sizeof(buffer), "%.3f", value);
+            result.append(buffer, static_cast<std::size_t>(length));
+        }
+        do_not_optimize(result);
+    });
+    run("numbers", "std::ostringstream << fixed << setprecision(3)" + suffix, [&]
+    {
+        std::ostringstream stream;
+        stream.setf(std::ios_base::fixed);
+        stream.precision(3);
+        for (auto const value : values.doubles)
+        {
+            stream << value;
+        }
+        do_not_optimize(stream.str());
+    });
+}
+
+}
@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+void parallel_build()
+{
+    // about 64 MiB in fragments of 64 bytes
+    bosswestfalen::string_builder sb;
+    std::string const fragment(64, 'x');
+    for (int i{0}; i < 1024 * 1024; ++i)
+    {
+        sb.add(fragment);
+    }
+
+    run("parallel_build", "build()", [&]
+    {
+        do_not_optimize(sb.build());
+    });
+
+    auto const hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads{1}; threads <= 2 * hardware; threads *= 2)
+    {
+        run("parallel_build", "build_parallel(" + std::to_string(threads) + ")", [&]
+        {
+            do_not_optimize(sb.build_parallel(threads, 0));
+        });
+    }
+
+    // writing the result to a file: build() and write() against a memory mapping
+    char path[]{"/tmp/sb_bench_XXXXXX"};
+    auto const fd = ::mkstemp(path);
+    if (fd < 0)
+    {
+        return;
+    }
+    run("parallel_build", "build() + write()", [&]
+    {
+        auto const result = sb.build();
+        ::ftruncate(fd, 0);
+        do_not_optimize(::pwrite(fd, result.data(), result.size(), 0));
+    });
+    for (unsigned threads{1}; threads <= hardware; threads *= 2)
+    {
+        run("parallel_build", "build_to_mapping(" + std::to_string(threads) + ")", [&]
+        {
+            do_not_optimize(sb.build_to_mapping(fd, bosswestfalen::mapping_options{bosswestfalen::mapping_sync::none, true, threads, 0}));
+        });
+    }
+    ::close(fd);
+    ::unlink(path);
+}
+
+}
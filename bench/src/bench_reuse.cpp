@@ -0,0 +1,63 @@
+#include <deque>
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+/// a response of about `fields` lines, written to `sb` and built into `response`
+template <typename Builder>
+void respond(Builder& sb, int const fields, std::string& response)
+{
+    sb.add("HTTP/1.1 200 OK\r\n");
+    for (int i{0}; i < fields; ++i)
+    {
+        sb.add("X-Field-", i, ": ", 1000 + i, "\r\n");
+    }
+    sb.add("\r\n");
+    sb.build_into(response);
+    do_not_optimize(response);
+}
+
+}
+
+void reuse()
+{
+    for (auto const fields : {8, 256, 8192})
+    {
+        auto const suffix = " fields=" + std::to_string(fields);
+        std::string response;
+
+        run("reuse", "new string_builder" + suffix, [&]
+        {
+            bosswestfalen::string_builder sb;
+            respond(sb, fields, response);
+        });
+
+        bosswestfalen::string_builder sb;
+        run("reuse", "string_builder::clear()" + suffix, [&]
+        {
+            sb.clear();
+            respond(sb, fields, response);
+        });
+
+        bosswestfalen::basic_string_builder<std::deque> deque_sb;
+        run("reuse", "basic_string_builder<std::deque>::clear()" + suffix, [&]
+        {
+            deque_sb.clear();
+            respond(deque_sb, fields, response);
+        });
+
+        run("reuse", "string_builder_pool::acquire()" + suffix, [&]
+        {
+            auto lease = bosswestfalen::string_builder_pool<>::local().acquire();
+            respond(*lease, fields, response);
+        });
+    }
+}
+
+}
@@ -0,0 +1,56 @@
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+void segments()
+{
+    for (auto const count : {8, 128, 4096})
+    {
+        bosswestfalen::string_builder sb;
+        for (int i{0}; i < count; ++i)
+        {
+            sb.add("/key/", i, "/value/", i * 31);
+        }
+        auto const expected = sb.build();
+        auto const prefix = expected.substr(0, 16);
+        auto const suffix = " count=" + std::to_string(count);
+
+        run("segments", "fnv1a(build())" + suffix, [&]
+        {
+            do_not_optimize(bosswestfalen::fnv1a(sb.build()));
+        });
+        run("segments", "hash()" + suffix, [&]
+        {
+            do_not_optimize(sb.hash());
+        });
+        run("segments", "build() == string" + suffix, [&]
+        {
+            do_not_optimize(sb.build() == expected);
+        });
+        run("segments", "equals()" + suffix, [&]
+        {
+            do_not_optimize(sb.equals(expected));
+        });
+        run("segments", "build() starts with" + suffix, [&]
+        {
+            do_not_optimize(sb.build().compare(0, prefix.size(), prefix) == 0);
+        });
+        run("segments", "starts_with()" + suffix, [&]
+        {
+            do_not_optimize(sb.starts_with(prefix));
+        });
+        run("segments", "build().find()" + suffix, [&]
+        {
+            do_not_optimize(sb.build().find("/value/-"));
+        });
+        run("segments", "find()" + suffix, [&]
+        {
+            do_not_optimize(sb.find("/value/-"));
+        });
+    }
+}
+
+}
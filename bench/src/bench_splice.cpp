@@ -0,0 +1,66 @@
+#include <string>
+#include <string_builder.hpp>
+#include "bench.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+/// render a document of nested sections: `depth` levels with `width` sections each
+template <bool Splice>
+void render(bosswestfalen::string_builder& out, int const depth, int const width, std::string const& text)
+{
+    out.add("<section depth=\"", depth, "\">");
+    if (depth == 0)
+    {
+        for (int i{0}; i < 16; ++i)
+        {
+            out.add("<p id=\"", i, "\">", text, "</p>");
+        }
+    }
+    else
+    {
+        for (int i{0}; i < width; ++i)
+        {
+            bosswestfalen::string_builder inner;
+            render<Splice>(inner, depth - 1, width, text);
+            if constexpr (Splice)
+            {
+                out.add(std::move(inner));
+            }
+            else
+            {
+                out.add(inner.build());
+            }
+        }
+    }
+    out.add("</section>");
+}
+
+}
+
+void splice()
+{
+    std::string const text(200, 'x');
+    for (auto const depth : {1, 3, 5})
+    {
+        auto const suffix = " depth=" + std::to_string(depth) + " width=4";
+
+        run("splice", "add(inner.build())" + suffix, [&]
+        {
+            bosswestfalen::string_builder document;
+            render<false>(document, depth, 4, text);
+            do_not_optimize(document.build());
+        });
+        run("splice", "add(std::move(inner))" + suffix, [&]
+        {
+            bosswestfalen::string_builder document;
+            render<true>(document, depth, 4, text);
+            do_not_optimize(document.build());
+        });
+    }
+}
+
+}
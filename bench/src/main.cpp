@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+//--------------------
+// Allocation counting
+//--------------------
+namespace
+{
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> bytes{0};
+
+void* counted_allocation(std::size_t const size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto const memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+}
+
+void* operator new(std::size_t const size)
+{
+    return counted_allocation(size);
+}
+
+void* operator new[](std::size_t const size)
+{
+    return counted_allocation(size);
+}
+
+void operator delete(void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* const memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* const memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+//--------------------
+// Command line and output
+//--------------------
+namespace
+{
+
+enum class format
+{
+    text,
+    csv,
+    json
+};
+
+format output_format{format::text};
+std::vector<std::string> filters;
+std::vector<bench::result> results;
+
+void print_text(bench::result const& r)
+{
+    std::printf("%-14s %-48s %10zu it %14.1f ns/op %8.2f allocs/op %10.1f B/op\n",
+                r.group.c_str(), r.name.c_str(), r.iterations, r.ns_per_op, r.allocations_per_op, r.bytes_per_op);
+    std::fflush(stdout);
+}
+
+void print_csv()
+{
+    std::printf("group,name,iterations,ns_per_op,allocations_per_op,bytes_per_op\n");
+    for (auto const& r : results)
+    {
+        std::printf("%s,\"%s\",%zu,%.3f,%.3f,%.3f\n",
+                    r.group.c_str(), r.name.c_str(), r.iterations, r.ns_per_op, r.allocations_per_op, r.bytes_per_op);
+    }
+}
+
+void print_json()
+{
+    std::printf("[\n");
+    for (std::size_t i{0}; i < results.size(); ++i)
+    {
+        auto const& r = results[i];
+        std::printf("  {\"group\": \"%s\", \"name\": \"%s\", \"iterations\": %zu, "
+                    "\"ns_per_op\": %.3f, \"allocations_per_op\": %.3f, \"bytes_per_op\": %.3f}%s\n",
+                    r.group.c_str(), r.name.c_str(), r.iterations, r.ns_per_op, r.allocations_per_op, r.bytes_per_op,
+                    i + 1 == results.size() ? "" : ",");
+    }
+    std::printf("]\n");
+}
+
+int usage(char const* const program)
+{
+    std::fprintf(stderr, "usage: %s [--format=text|csv|json] [group...]\n", program);
+    return EXIT_FAILURE;
+}
+
+}
+
+namespace bench
+{
+
+std::size_t allocation_count() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t allocated_bytes() noexcept
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+bool selected(std::string const& group)
+{
+    if (filters.empty())
+    {
+        return true;
+    }
+    for (auto const& filter : filters)
+    {
+        if (filter == group)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void report(result const& measurement)
+{
+    results.push_back(measurement);
+    if (output_format == format::text)
+    {
+        print_text(measurement);
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    for (int i{1}; i < argc; ++i)
+    {
+        std::string const argument{argv[i]};
+        if (argument == "--format=text")
+        {
+            output_format = format::text;
+        }
+        else if (argument == "--format=csv")
+        {
+            output_format = format::csv;
+        }
+        else if (argument == "--format=json")
+        {
+            output_format = format::json;
+        }
+        else if (argument.rfind("--", 0) == 0)
+        {
+            return usage(argv[0]);
+        }
+        else
+        {
+            filters.push_back(argument);
+        }
+    }
+
+    bench::conversion();
+    bench::numbers();
+    bench::escape();
+    bench::add_build();
+    bench::reuse();
+    bench::segments();
+    bench::splice();
+    bench::concat();
+    bench::parallel_build();
+    bench::concurrent();
+
+    if (output_format == format::csv)
+    {
+        print_csv();
+    }
+    else if (output_format == format::json)
+    {
+        print_json();
+    }
+}
@@ -27,13 +27,65 @@
 /// > SOFTWARE.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <memory>
+#if __has_include(<memory_resource>)
+/// Defined if `std::pmr` is available.
+#define BOSSWESTFALEN_SB_PMR
+#include <memory_resource>
+#endif
+#include <mutex>
 #include <numeric>
-#include <sstream>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#if __has_include(<sys/uio.h>) && __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+/// Defined if POSIX I/O (e.g. `writev` and `mmap`) is available.
+#define BOSSWESTFALEN_SB_POSIX
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+/// Defined if the conversion checks use concepts (C++20), see `type_traits::appendable`.
+#define BOSSWESTFALEN_SB_CONCEPTS
+#endif
+
+#ifndef BOSSWESTFALEN_SB_NO_SIMD
+#if defined(__AVX2__) && __has_include(<immintrin.h>)
+/// Defined if AVX2 instructions are used (e.g. to find characters that need escaping).
+#define BOSSWESTFALEN_SB_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) && __has_include(<emmintrin.h>)
+/// Defined if SSE2 instructions are used (e.g. to find characters that need escaping).
+#define BOSSWESTFALEN_SB_SSE2
+#include <emmintrin.h>
+#endif
+#endif // BOSSWESTFALEN_SB_NO_SIMD
 
 
 /// \brief Bosswestfalen's namespace
@@ -41,6 +93,83 @@
 namespace bosswestfalen
 {
 
+/// \brief Output interface to write characters directly into a destination.
+///
+/// A `sink` is handed to `sb_append` hooks (see `append_to`), so that
+/// a value can be written without creating a temporary `std::string`.
+/// Concrete sinks decide where the characters end up (e.g. `string_sink`).
+///
+/// \note `sink` is not thread-safe.
+class sink
+{
+  public:
+    /// \brief Append `count` characters starting at `data`.
+    ///
+    /// \throws any exception thrown by the destination (e.g. `std::bad_alloc`)
+    void append(char const* data, std::size_t count)
+    {
+        if (count != 0)
+        {
+            do_append(data, count);
+        }
+    }
+
+    /// Append all characters of `text`.
+    void append(std::string_view text)
+    {
+        append(text.data(), text.size());
+    }
+
+    /// Append a single character.
+    void push_back(char const character)
+    {
+        do_append(&character, 1);
+    }
+
+  protected:
+    /// Only derived classes can be constructed.
+    sink() = default;
+    /// Copying is allowed for derived classes.
+    sink(sink const&) = default;
+    /// Copying is allowed for derived classes.
+    sink& operator=(sink const&) = default;
+    /// No polymorphic destruction.
+    ~sink() = default;
+
+  private:
+    /// Write `count` (> 0) characters starting at `data` to the destination.
+    virtual void do_append(char const* data, std::size_t count) = 0;
+};
+
+/// \brief `sink` that appends to an existing string.
+///
+/// \tparam String The type of the string, e.g. `std::string` or `std::pmr::string`.
+template <typename String>
+class basic_string_sink final : public sink
+{
+  public:
+    /// \brief Create a sink that writes to `target`.
+    ///
+    /// \param target The string characters are appended to.
+    ///     Must outlive the `basic_string_sink`.
+    explicit basic_string_sink(String& target) noexcept
+        : target{target}
+    {
+    }
+
+  private:
+    /// Destination
+    String& target;
+
+    void do_append(char const* data, std::size_t count) override
+    {
+        target.append(data, count);
+    }
+};
+
+/// `sink` that appends to an existing `std::string`.
+using string_sink = basic_string_sink<std::string>;
+
 /// \brief Helper namespace for type_traits needed for string conversion
 namespace type_traits
 {
@@ -133,209 +262,5455 @@ struct has_stream_operator<T, std::void_t<
 {
 };
 
-}
+/// Available if `T` (without reference) is no array of `char const`
+template <typename T>
+struct is_const_char_array : std::false_type
+{
+};
 
-#ifdef BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+/// Available if `T` (without reference) is an array of `char const`, e.g. a string literal
+template <typename T>
+struct is_const_char_array<T&> : is_const_char_array<T>
+{
+};
 
-/// \brief Convert a value of an arbitrary type to `std::string`.
-///
-/// To convert the value to `std::string` its type `T` must meet at
-/// least one of the following requirements:
-/// * `T` is an `arithmetic`type, like `bool`, `int`, `double`, etc.
-/// * `static_cast<std::string>(T)` is possible
-/// * a function `to_string(T)` exists
-/// * `operator<<(ostream, U)` exists, where `U` is `T` or a type `T` can be implicitly converted to
-/// The decision tree below shows the order of checks.
-///
-/// \tparam T The type of the input value.
-/// \param value The value that will be converted to `std::string`.
-///
-/// \return `std::string` representation of input `value`.
-///
-/// \attention A function with this signature does not actually exist. 
-///     Instead several `make_string` functions are checked and the 
-///     *best match* is selected via SFINEA.
-///
-/// \startuml{to_string_decision.png} "How template type T is converted"
-/// :bosswestfalen::make_string<T>(input);
-/// -> Analyze template type T;
-/// if (T is an arithmetic type) then (yes)
-///   :return std::to_string(value);
-///   stop
-/// else (no)
-///   if (static_cast<std::string>(T) possible) then (yes)
-///     :return static_cast<std::string>(value);
-///     stop
-///   else (no)
-///     if (to_string(T) is available and the result can be converted to `std::string`) then (yes)
-///       : return bosswestfalen::make_string(to_string(value));
-///       stop
-///     else (no)
-///     if (operator<<(std::ostream, T) is available) then (yes)
-///       : ostream << value \nreturn ostream.str();
-///       stop
-///   else (no)
-///     -> compilation fails;
-///     stop
-/// \enduml
+/// Available if `T` (without reference) is an array of `char const`, e.g. a string literal
+template <std::size_t N>
+struct is_const_char_array<char const[N]> : std::true_type
+{
+};
+
+/// Available if `T` (without cv-qualifiers) is no `std::pair`
 template <typename T>
-std::string make_string(T&& value);
+struct is_pair : std::false_type
+{
+};
 
-#else // BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+/// Available if `T` (without cv-qualifiers) is a `std::pair`
+template <typename T, typename U>
+struct is_pair<std::pair<T, U>> : std::true_type
+{
+};
 
+/// Available if `T` (without cv-qualifiers) is a `std::pair`
 template <typename T>
-auto make_string(T&& value) -> std::enable_if_t
-    <
-        type_traits::is_builtin_type<T>::value
-    ,
-    std::string
-    >
+struct is_pair<T const> : is_pair<T>
 {
-    return std::to_string(value);
-}
+};
+
+/// Available if `std::begin(T)` and `std::end(T)` cannot be called
+template <typename T,
+          typename = std::void_t<>>
+struct is_range : std::false_type
+{
+};
 
+/// Available if `std::begin(T)` and `std::end(T)` can be called
 template <typename T>
-auto make_string(T&& value) -> std::enable_if_t
-    <
-        type_traits::is_automatically_convertible<T>::value
-    , 
-    std::string
-    >
+struct is_range<T, std::void_t<
+    decltype(std::begin(std::declval<T const&>())),
+    decltype(std::end(std::declval<T const&>()))
+    >> : std::true_type
+{
+};
+
+/// Available if `sb_append(sink&, T)` cannot be called
+template <typename T,
+          typename = std::void_t<>>
+struct has_sb_append : std::false_type
+{
+};
+
+/// Available if `sb_append(sink&, T)` can be called (found via ADL)
+template <typename T>
+struct has_sb_append<T, std::void_t<
+    decltype(sb_append(std::declval<sink&>(), std::declval<T>()))
+    >> : std::true_type
+{
+};
+
+// The checks used by `append_to`. With concepts they are requires-expressions,
+// which the compiler evaluates without instantiating the class templates above.
+#ifdef BOSSWESTFALEN_SB_CONCEPTS
+
+/// Whether `T` (without reference) is an `arithmetic` built-in type, see `is_builtin_type`
+template <typename T>
+inline constexpr bool is_builtin_type_v = std::is_arithmetic_v<std::remove_reference_t<T>>;
+
+/// Whether `T` can be converted to `std::string` with `static_cast`, see `is_automatically_convertible`
+template <typename T>
+inline constexpr bool is_automatically_convertible_v = requires
+{
+    static_cast<std::string>(std::declval<T>());
+};
+
+/// Whether `to_string(T)` can be called and its result is convertible to `std::string`, see `has_external_to_string`
+template <typename T>
+inline constexpr bool has_external_to_string_v = requires
+{
+    static_cast<std::string>(to_string(std::declval<T>()));
+};
+
+/// Whether `stream << T` can be called, see `has_stream_operator`
+template <typename T>
+inline constexpr bool has_stream_operator_v = requires
+{
+    requires std::is_same_v<std::ostream, std::remove_reference_t<
+        decltype(operator<<(std::declval<std::ostream>(), std::declval<T>()))>>;
+};
+
+/// Whether `sb_append(sink&, T)` can be called, see `has_sb_append`
+template <typename T>
+inline constexpr bool has_sb_append_v = requires
+{
+    sb_append(std::declval<sink&>(), std::declval<T>());
+};
+
+/// \brief Satisfied if `append_to` can write a `T`.
+///
+/// The checks are done in the order of `append_to` and stop at the first one that succeeds.
+template <typename T>
+concept appendable = has_sb_append_v<T> or has_external_to_string_v<T> or has_stream_operator_v<T>;
+
+#else // BOSSWESTFALEN_SB_CONCEPTS
+
+/// Whether `T` (without reference) is an `arithmetic` built-in type, see `is_builtin_type`
+template <typename T>
+inline constexpr bool is_builtin_type_v = is_builtin_type<T>::value;
+
+/// Whether `T` can be converted to `std::string` with `static_cast`, see `is_automatically_convertible`
+template <typename T>
+inline constexpr bool is_automatically_convertible_v = is_automatically_convertible<T>::value;
+
+/// Whether `to_string(T)` can be called and its result is convertible to `std::string`, see `has_external_to_string`
+template <typename T>
+inline constexpr bool has_external_to_string_v = has_external_to_string<T>::value;
+
+/// Whether `stream << T` can be called, see `has_stream_operator`
+template <typename T>
+inline constexpr bool has_stream_operator_v = has_stream_operator<T>::value;
+
+/// Whether `sb_append(sink&, T)` can be called, see `has_sb_append`
+template <typename T>
+inline constexpr bool has_sb_append_v = has_sb_append<T>::value;
+
+#endif // BOSSWESTFALEN_SB_CONCEPTS
+
+}
+
+/// \brief Helper namespace for implementation details
+namespace detail
+{
+
+/// The decimal digits of 0 to 99, two characters each.
+inline constexpr char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/// \brief Write `value` in decimal notation to the end of `buffer`.
+///
+/// Two digits are written at a time (see `digit_pairs`).
+/// Same output as `std::to_string`, but usable in constant expressions.
+///
+/// \return Index of the first character written.
+template <typename T, std::size_t N>
+constexpr std::size_t format_decimal(char (&buffer)[N], T const value) noexcept
 {
-    return static_cast<std::string>(value);
+    static_assert(N > std::numeric_limits<T>::digits10 + 1, "buffer too small");
+    using unsigned_type = std::make_unsigned_t<T>;
+    auto magnitude = static_cast<unsigned_type>(value);
+    auto negative = false;
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < 0)
+        {
+            negative = true;
+            magnitude = static_cast<unsigned_type>(unsigned_type{0} - magnitude);
+        }
+    }
+
+    auto position = N;
+    while (magnitude >= 100)
+    {
+        auto const pair = static_cast<std::size_t>(magnitude % 100) * 2;
+        magnitude = static_cast<unsigned_type>(magnitude / 100);
+        buffer[--position] = digit_pairs[pair + 1];
+        buffer[--position] = digit_pairs[pair];
+    }
+    if (magnitude >= 10)
+    {
+        auto const pair = static_cast<std::size_t>(magnitude) * 2;
+        buffer[--position] = digit_pairs[pair + 1];
+        buffer[--position] = digit_pairs[pair];
+    }
+    else
+    {
+        buffer[--position] = static_cast<char>('0' + magnitude);
+    }
+
+    if (negative)
+    {
+        buffer[--position] = '-';
+    }
+    return position;
 }
 
+/// Write an integral value in decimal notation (same output as `std::to_string`).
 template <typename T>
-auto make_string(T&& value) -> std::enable_if_t
+auto append_arithmetic(sink& out, T const value) -> std::enable_if_t
     <
-        type_traits::has_external_to_string<T>::value
-        and not type_traits::is_automatically_convertible<T>::value
-    ,
-    std::string
+        std::is_integral_v<T>
     >
 {
-    return make_string(to_string(std::forward<T>(value)));
+    // integral promotion turns bool and character types into int (as std::to_string does)
+    auto const promoted = +value;
+    char buffer[std::numeric_limits<decltype(promoted)>::digits10 + 3];
+    auto const first = format_decimal(buffer, promoted);
+    out.append(buffer + first, sizeof(buffer) - first);
 }
 
+/// \brief Write a floating point value in the shortest form that reads back as the same value.
+///
+/// Uses `std::to_chars`, i.e. the output does not depend on the locale.
+/// Examples: `0.5`, `10`, `1e+300`, `inf`, `nan`.
 template <typename T>
-auto make_string(T&& value) -> std::enable_if_t
+auto append_arithmetic(sink& out, T const value) -> std::enable_if_t
     <
-        type_traits::has_stream_operator<T>::value
-        and not type_traits::is_builtin_type<T>::value
-        and not type_traits::is_automatically_convertible<T>::value
-        and not type_traits::has_external_to_string<T>::value
-    ,
-    std::string
+        std::is_floating_point_v<T>
     >
 {
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
+    // sign, digits, decimal point, and exponent
+    char buffer[std::numeric_limits<T>::max_digits10 + 10];
+    auto const [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    assert(ec == std::errc{});
+    out.append(buffer, static_cast<std::size_t>(end - buffer));
 }
 
-#endif // BOSSWESTFALEN_ONLY_FOR_DOXYGEN
-
-
-/// \brief The `basic_string_builder` allows to easily concatenate strings.
-///
-/// Strings are collected and concatenated on demand.
-/// Concatenating *a*, *b*, and *c* yields the string *abc*.
-///
-/// \tparam Cont The container used to store the `std::strings`.
-///     Must support 
-///     * `emplace_back`
-///     * `back`, 
-///     * `pop_back`
-///     * `std::cbegin`
-///     * `std::cend`
+/// \brief `std::streambuf` that passes the characters to a `sink`.
 ///
-/// \note `basic_string_builder` is not thread-safe.
-template <template <typename> typename Cont>
-class basic_string_builder final
+/// Characters are collected in a small internal buffer, large writes go to the sink directly.
+/// No memory is allocated.
+class sink_streambuf final : public std::streambuf
 {
   public:
-    /// Default Ctor is sufficient.
-    basic_string_builder() = default;
+    /// No sink is attached.
+    sink_streambuf() noexcept
+    {
+        attach(nullptr);
+    }
 
-    /// Nothing special to do on destruction.
-    ~basic_string_builder() = default;
+    /// Write to `out` from now on, buffered characters are discarded.
+    void attach(sink* const out) noexcept
+    {
+        target = out;
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
 
-    /// \brief Add new content to the `basic_string_builder`.
-    ///
-    /// If required *input* will be converted to a std::string.
-    /// It then is stored internally and will be used in `build()`.
-    ///
-    /// \tparam T The type of the input value.
-    /// \param value The value that will be converted to `std::string`
-    ///     and added to the internal storage.
-    ///
-    /// \throws std::length_error if the size of the result of `build()`
-    ///     would be larger than the `std::string::max_size()`
-    /// \throws any exception that occurs during creation and storing
-    ///     (e.g. exceptions when creating the `std::string` or adding it
-    ///     to the container, with `emplace_back`)
-    template <typename T>
-    void add(T&& value)
+    /// Pass the buffered characters to the sink.
+    void flush_buffer()
     {
-        storage.emplace_back(bosswestfalen::make_string(std::forward<T>(value)));
+        if (pptr() != pbase())
+        {
+            target->append(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            setp(buffer.data(), buffer.data() + buffer.size());
+        }
+    }
 
-        auto const new_size = storage.back().size();
-        static auto max_size = storage.back().max_size();
+  protected:
+    int_type overflow(int_type const character) override
+    {
+        flush_buffer();
+        if (not traits_type::eq_int_type(character, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(character);
+            pbump(1);
+        }
+        return traits_type::not_eof(character);
+    }
 
-        if (result_size > max_size - new_size)
+    std::streamsize xsputn(char const* const data, std::streamsize const count) override
+    {
+        auto const size = static_cast<std::size_t>(count);
+        if (size > static_cast<std::size_t>(epptr() - pptr()))
         {
-            storage.pop_back();
-            throw std::length_error{""};
+            flush_buffer();
+            if (size >= buffer.size())
+            {
+                target->append(data, size);
+                return count;
+            }
         }
+        std::copy_n(data, size, pptr());
+        pbump(static_cast<int>(size));
+        return count;
+    }
 
-        result_size += new_size;
+    int sync() override
+    {
+        flush_buffer();
+        return 0;
     }
 
-    /// \brief Concatenate stored strings.
-    ///
-    /// All strings added so far will be concatenated without any delimiter.
-    /// Stored strings *a*, *b*, and *c* will result in *abc*.
-    /// 
-    /// \note The result is not stored.
-    /// Additional calls to `build()` will result in re-building, even if nothing changed.
+  private:
+    /// Characters not passed to the sink yet.
+    std::array<char, 256> buffer{};
+    /// The sink written to.
+    sink* target{nullptr};
+};
+
+/// \brief A `std::ostream` writing to a `sink`, reused for many values.
+class sink_stream final
+{
+  public:
+    /// Exceptions of the sink are passed to the caller.
+    sink_stream()
+    {
+        stream.exceptions(std::ios_base::badbit);
+    }
+
+    sink_stream(sink_stream const&) = delete;
+    sink_stream& operator=(sink_stream const&) = delete;
+
+    /// Nothing special to do on destruction.
+    ~sink_stream() = default;
+
+    /// Whether `write()` is running (e.g. `operator<<` of a value writes another value).
+    bool in_use() const noexcept
+    {
+        return used;
+    }
+
+    /// \brief Write `value` with `operator<<` to `out`.
     ///
-    /// \return The concatenation of all stored strings.
-    std::string build() const
+    /// The formatting state (flags, precision, width, fill, locale) is reset before,
+    /// so changes made by a previous `operator<<` do not leak.
+    template <typename T>
+    void write(sink& out, T const& value)
     {
-        if (storage.empty())
+        reset();
+        used = true;
+        buffer.attach(&out);
+        struct release final
         {
-            return std::string{};
-        }
+            sink_stream& self;
 
-        if (storage.size() == 1)
-        {
-            return storage.front();
-        }
+            ~release()
+            {
+                self.buffer.attach(nullptr);
+                self.used = false;
+            }
+        } const guard{*this};
 
-        return concatenate();
+        stream << value;
+        buffer.flush_buffer();
     }
 
   private:
-    /// Size of the resulting string
-    std::string::size_type result_size{0};
-    /// Internal storage
-    Cont<std::string> storage{};
+    /// Receives the characters.
+    sink_streambuf buffer{};
+    /// Formats the values.
+    std::ostream stream{&buffer};
+    /// Locale of a new stream.
+    std::locale const locale{stream.getloc()};
+    /// Whether `write()` is running.
+    bool used{false};
 
-    /// Concatenate stored strings.
-    std::string concatenate() const
-    { 
-        std::string result;
-        result.reserve(result_size);
-        std::for_each(std::cbegin(storage), std::cend(storage), [&result](auto const& element)
+    /// Restore the state of a new stream.
+    void reset()
+    {
+        stream.clear();
+        stream.flags(std::ios_base::skipws | std::ios_base::dec);
+        stream.precision(6);
+        stream.width(0);
+        stream.fill(' ');
+        if (stream.exceptions() != std::ios_base::badbit)
         {
-            result.append(element);
-        });
-        return result;
+            stream.exceptions(std::ios_base::badbit);
+        }
+        if (stream.getloc() != locale)
+        {
+            stream.imbue(locale);
+        }
     }
 };
 
-/// Alias to use `string_builder` with `std::deque`.
-using string_builder = basic_string_builder<std::deque>;
+/// The stream of the calling thread, shared by all types written with `stream_to()`.
+inline sink_stream& local_stream()
+{
+    thread_local sink_stream stream;
+    return stream;
+}
+
+/// \brief Write `value` with `operator<<` to `out`.
+///
+/// The stream of the thread is reused (see `local_stream()`); a nested call
+/// (from within `operator<<`) uses a new stream.
+template <typename T>
+void stream_to(sink& out, T const& value)
+{
+    auto& stream = local_stream();
+    if (stream.in_use())
+    {
+        sink_stream nested;
+        nested.write(out, value);
+    }
+    else
+    {
+        stream.write(out, value);
+    }
+}
+
+}
+
+/// \brief Built-in `sb_append` hook for `arithmetic` types and types that can be converted with `static_cast<std::string>`.
+///
+/// Integers are written like `std::to_string(value)`, floating point values in the shortest form
+/// that reads back as the same value (e.g. `0.5`). See `formatted_number` for other formats.
+///
+/// String-like types that convert to `std::string_view` (e.g. `std::string`,
+/// `char const*`, string literals) are written without creating a `std::string`.
+template <typename T>
+auto sb_append(sink& out, T const& value) -> std::enable_if_t
+    <
+        type_traits::is_builtin_type_v<T>
+        or type_traits::is_automatically_convertible_v<T const&>
+    >
+{
+    if constexpr (type_traits::is_builtin_type_v<T>)
+    {
+        detail::append_arithmetic(out, value);
+    }
+    else if constexpr (std::is_convertible_v<T const&, std::string_view>)
+    {
+        out.append(std::string_view{value});
+    }
+    else
+    {
+        out.append(static_cast<std::string>(value));
+    }
+}
+
+/// Notation of a `formatted_number`.
+enum class number_notation
+{
+    /// Shortest representation that reads back as the same value (default).
+    shortest,
+    /// Fixed-point notation, e.g. `3.142`.
+    fixed,
+    /// Scientific notation, e.g. `3.142e+00`.
+    scientific,
+    /// Fixed or scientific notation with a number of significant digits, like `"%g"`.
+    general,
+    /// Hexadecimal notation, e.g. `ff` or `1.8p+1`.
+    hex
+};
+
+/// \brief An arithmetic value with explicit formatting.
+///
+/// Created by `fixed()`, `scientific()`, `precision()`, `hex()`, and `width()`,
+/// e.g. `sb.add(fixed(x, 3))`. The number is written directly to the destination.
+///
+/// \tparam T The arithmetic type of the value.
+template <typename T>
+struct formatted_number final
+{
+    static_assert(std::is_arithmetic_v<T>, "only arithmetic types can be formatted");
+
+    /// The value to write.
+    T value;
+    /// How to write the value.
+    number_notation notation{number_notation::shortest};
+    /// Digits after the decimal point (`general`: significant digits); negative for the shortest form.
+    int precision{-1};
+    /// Minimal number of characters; shorter output is padded at the front.
+    std::size_t width{0};
+    /// Character used for padding.
+    char fill{' '};
+};
+
+/// \brief Write `value` in fixed-point notation with `digits` digits after the decimal point.
+///
+/// Same output as `"%.*f"` in the "C" locale.
+template <typename T>
+constexpr formatted_number<T> fixed(T const value, int const digits = 6) noexcept
+{
+    static_assert(std::is_floating_point_v<T>, "fixed() requires a floating point value");
+    return formatted_number<T>{value, number_notation::fixed, digits};
+}
+
+/// \brief Write `value` in scientific notation.
+///
+/// \param digits Digits after the decimal point; if negative, the shortest form is used.
+template <typename T>
+constexpr formatted_number<T> scientific(T const value, int const digits = -1) noexcept
+{
+    static_assert(std::is_floating_point_v<T>, "scientific() requires a floating point value");
+    return formatted_number<T>{value, number_notation::scientific, digits};
+}
+
+/// \brief Write `value` with `digits` significant digits.
+///
+/// Same output as `"%.*g"` in the "C" locale.
+template <typename T>
+constexpr formatted_number<T> precision(T const value, int const digits) noexcept
+{
+    static_assert(std::is_floating_point_v<T>, "precision() requires a floating point value");
+    return formatted_number<T>{value, number_notation::general, digits};
+}
+
+/// \brief Write `value` in hexadecimal notation without prefix.
+///
+/// Integers are written with lowercase digits (e.g. `ff`, `-1a`),
+/// floating point values in the shortest hexadecimal form (e.g. `1.8p+1`).
+template <typename T>
+constexpr formatted_number<T> hex(T const value) noexcept
+{
+    return formatted_number<T>{value, number_notation::hex};
+}
+
+/// \brief Write `number` with at least `characters` characters.
+///
+/// Shorter output is padded with `fill` at the front, e.g. `width(fixed(x, 2), 8)`.
+/// With `fill` `'0'` the zeros follow a minus sign, like `"%08.2f"`.
+template <typename T>
+constexpr formatted_number<T> width(formatted_number<T> number, std::size_t const characters, char const fill = ' ') noexcept
+{
+    number.width = characters;
+    number.fill = fill;
+    return number;
+}
+
+/// \brief Write `value` with at least `characters` characters.
+///
+/// Shorter output is padded with `fill` at the front, e.g. `width(42, 5, '0')` yields `00042`
+/// and `width(-42, 5, '0')` yields `-0042`.
+template <typename T>
+constexpr auto width(T const value, std::size_t const characters, char const fill = ' ') noexcept
+    -> std::enable_if_t<std::is_arithmetic_v<T>, formatted_number<T>>
+{
+    return width(formatted_number<T>{value}, characters, fill);
+}
+
+namespace detail
+{
+
+/// Write `number` to [`first`, `last`) with `std::to_chars`.
+template <typename T>
+std::to_chars_result format_number(char* const first, char* const last, formatted_number<T> const& number)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        // integral promotion turns bool and character types into int
+        return std::to_chars(first, last, +number.value, number.notation == number_notation::hex ? 16 : 10);
+    }
+    else
+    {
+        auto const with_precision = [&](std::chars_format const format)
+        {
+            return number.precision < 0
+                ? std::to_chars(first, last, number.value, format)
+                : std::to_chars(first, last, number.value, format, number.precision);
+        };
+        switch (number.notation)
+        {
+            case number_notation::fixed:
+                return with_precision(std::chars_format::fixed);
+            case number_notation::scientific:
+                return with_precision(std::chars_format::scientific);
+            case number_notation::general:
+                return with_precision(std::chars_format::general);
+            case number_notation::hex:
+                return with_precision(std::chars_format::hex);
+            case number_notation::shortest:
+                break;
+        }
+        return std::to_chars(first, last, number.value);
+    }
+}
+
+/// \brief Write `count` characters starting at `data` to `out`, padded at the front to `number.width`.
+///
+/// Like `"%0*d"`, zeros are inserted after a minus sign, and infinity and NaN are padded with spaces.
+template <typename T>
+void append_padded(sink& out, formatted_number<T> const& number, char const* const data, std::size_t const count)
+{
+    auto fill = number.fill;
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (fill == '0' and not std::isfinite(number.value))
+        {
+            fill = ' ';
+        }
+    }
+    std::size_t sign{0};
+    if (fill == '0' and count > 0 and data[0] == '-')
+    {
+        out.push_back('-');
+        sign = 1;
+    }
+    for (auto padding = count; padding < number.width; ++padding)
+    {
+        out.push_back(fill);
+    }
+    out.append(data + sign, count - sign);
+}
+
+}
+
+/// \brief `sb_append` hook for `formatted_number`.
+///
+/// The number is formatted into a buffer on the stack;
+/// only very long output (e.g. `fixed(1e300, 10)`) needs a heap buffer.
+template <typename T>
+void sb_append(sink& out, formatted_number<T> const& number)
+{
+    char buffer[128];
+    auto const result = detail::format_number(std::begin(buffer), std::end(buffer), number);
+    if (result.ec == std::errc{})
+    {
+        detail::append_padded(out, number, buffer, static_cast<std::size_t>(result.ptr - buffer));
+        return;
+    }
+
+    for (std::size_t size{2 * sizeof(buffer)};; size *= 2)
+    {
+        std::string large(size, '\0');
+        auto const [end, ec] = detail::format_number(large.data(), large.data() + size, number);
+        if (ec == std::errc{})
+        {
+            detail::append_padded(out, number, large.data(), static_cast<std::size_t>(end - large.data()));
+            return;
+        }
+    }
+}
+
+#ifdef BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+
+/// \brief Write a value of an arbitrary type to a `sink`.
+///
+/// To write the value its type `T` must meet at least one of the following requirements:
+/// * a function `sb_append(sink&, T const&)` exists (found via ADL).
+///   Built-in hooks exist for
+///   * `arithmetic` types, like `bool`, `int`, `double`, etc.
+///   * types for which `static_cast<std::string>(T)` is possible
+///   * `formatted_number`, see `fixed()`, `scientific()`, `precision()`, `hex()`, and `width()`
+/// * a function `to_string(T)` exists
+/// * `operator<<(ostream, U)` exists, where `U` is `T` or a type `T` can be implicitly converted to
+/// The decision tree below shows the order of checks.
+///
+/// A custom type can be written without any temporary `std::string`
+/// by providing a hook in its own namespace:
+/// \code
+/// namespace my
+/// {
+/// struct point { int x; int y; };
+///
+/// void sb_append(bosswestfalen::sink& out, point const& p)
+/// {
+///     bosswestfalen::append_to(out, p.x);
+///     out.push_back('/');
+///     bosswestfalen::append_to(out, p.y);
+/// }
+/// }
+/// \endcode
+///
+/// \tparam T The type of the input value.
+/// \param out The sink the characters are written to.
+/// \param value The value that will be written.
+///
+/// \note The checks are done one after the other with `if constexpr`, so only the checks up to
+///     the first match are evaluated. A type without conversion fails a `static_assert`;
+///     with C++20 `append_to` is constrained by the concept `type_traits::appendable` instead.
+///
+/// \startuml{to_string_decision.png} "How template type T is converted"
+/// :bosswestfalen::append_to<T>(out, input);
+/// -> Analyze template type T;
+/// if (sb_append(sink&, T) is available) then (yes)
+///   :sb_append(out, value);
+///   note right
+///     built-in hooks:
+///     * arithmetic type: decimal digits or shortest round-trip std::to_chars
+///     * static_cast<std::string>(T) possible: append characters
+///   end note
+///   stop
+/// else (no)
+///   if (to_string(T) is available and the result can be converted to `std::string`) then (yes)
+///     : bosswestfalen::append_to(out, to_string(value));
+///     stop
+///   else (no)
+///   if (operator<<(std::ostream, T) is available) then (yes)
+///     : ostream << value;
+///     note right
+///       reused ostream writing to out,
+///       formatting state is reset
+///     end note
+///     stop
+///   else (no)
+///     -> compilation fails;
+///     stop
+/// \enduml
+template <typename T>
+void append_to(sink& out, T&& value);
+
+#else // BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+
+template <typename T>
+#ifdef BOSSWESTFALEN_SB_CONCEPTS
+    requires type_traits::appendable<T>
+#endif
+void append_to(sink& out, T&& value)
+{
+    // a single resolver: every check is done at most once, in order of precedence
+    if constexpr (type_traits::has_sb_append_v<T>)
+    {
+        sb_append(out, value);
+    }
+    else if constexpr (type_traits::has_external_to_string_v<T>)
+    {
+        append_to(out, to_string(std::forward<T>(value)));
+    }
+    else
+    {
+        static_assert(type_traits::has_stream_operator_v<T>,
+                      "T needs sb_append(sink&, T), to_string(T), or operator<<(std::ostream&, T)");
+        detail::stream_to(out, value);
+    }
+}
+
+#endif // BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+
+/// \brief Convert a value of an arbitrary type to `std::string`.
+///
+/// The conversion rules of `append_to` are used.
+///
+/// \tparam T The type of the input value.
+/// \param value The value that will be converted to `std::string`.
+///
+/// \return `std::string` representation of input `value`.
+template <typename T>
+std::string make_string(T&& value)
+{
+    std::string result;
+    string_sink out{result};
+    append_to(out, std::forward<T>(value));
+    return result;
+}
+
+
+namespace detail
+{
+
+/// \brief The characters of `array`, without the terminating null character if there is one.
+///
+/// The length is taken from the extent `N`, so arrays without null character are not read beyond their end.
+template <std::size_t N>
+constexpr std::string_view array_view(char const (&array)[N]) noexcept
+{
+    return std::string_view{array, N > 0 and array[N - 1] == '\0' ? N - 1 : N};
+}
+
+/// `sink` that only counts the characters written to it.
+class counting_sink final : public sink
+{
+  public:
+    /// Number of characters written so far.
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+  private:
+    /// Number of characters written so far.
+    std::size_t count{0};
+
+    void do_append(char const*, std::size_t const size) override
+    {
+        count += size;
+    }
+};
+
+/// \brief `sink` writing to an inline buffer of `N` characters.
+///
+/// If more than `N` characters are written, the content is moved to a `std::string`.
+template <std::size_t N>
+class inline_sink final : public sink
+{
+  public:
+    /// All characters written so far.
+    std::string_view view() const noexcept
+    {
+        return spilled ? std::string_view{overflow} : std::string_view{buffer, length};
+    }
+
+  private:
+    /// Inline storage.
+    char buffer[N];
+    /// Number of characters in `buffer`.
+    std::size_t length{0};
+    /// Whether `overflow` is used instead of `buffer`.
+    bool spilled{false};
+    /// Storage if `buffer` is too small.
+    std::string overflow{};
+
+    void do_append(char const* data, std::size_t const count) override
+    {
+        if (not spilled and count <= N - length)
+        {
+            std::copy(data, data + count, buffer + length);
+            length += count;
+            return;
+        }
+        if (not spilled)
+        {
+            overflow.reserve(length + count);
+            overflow.assign(buffer, length);
+            spilled = true;
+        }
+        overflow.append(data, count);
+    }
+};
+
+/// \brief A value of type `T` whose size after conversion is known.
+///
+/// Used to measure all values before writing them (see `concat`).
+/// This primary template converts the value with `make_string`
+/// (`to_string`, `operator<<`, or conversion operator).
+template <typename T,
+          typename = void>
+class prepared_argument final
+{
+  public:
+    /// Convert `value`.
+    explicit prepared_argument(T const& value)
+        : text{make_string(value)}
+    {
+    }
+
+    /// Number of characters `write` produces.
+    std::size_t size() const noexcept
+    {
+        return text.size();
+    }
+
+    /// Write the converted value to `out`.
+    void write(sink& out) const
+    {
+        out.append(text);
+    }
+
+  private:
+    /// The converted value.
+    std::string text;
+};
+
+/// Strings, string literals, and other types that convert to `std::string_view` are used directly.
+template <typename T>
+class prepared_argument<T, std::enable_if_t
+    <
+        std::is_convertible_v<T const&, std::string_view>
+    >> final
+{
+  public:
+    /// Refer to the characters of `value`. For literals the length is computed at compile time.
+    explicit prepared_argument(T const& value)
+        : text{value}
+    {
+    }
+
+    /// Number of characters `write` produces.
+    std::size_t size() const noexcept
+    {
+        return text.size();
+    }
+
+    /// Write the characters to `out`.
+    void write(sink& out) const
+    {
+        out.append(text);
+    }
+
+  private:
+    /// The characters.
+    std::string_view text;
+};
+
+/// `arithmetic` types are formatted once into an inline buffer.
+template <typename T>
+class prepared_argument<T, std::enable_if_t
+    <
+        type_traits::is_builtin_type_v<T>
+    >> final
+{
+  public:
+    /// Format `value`.
+    explicit prepared_argument(T const value)
+    {
+        append_to(buffer, value);
+    }
+
+    /// Number of characters `write` produces.
+    std::size_t size() const noexcept
+    {
+        return buffer.view().size();
+    }
+
+    /// Write the formatted value to `out`.
+    void write(sink& out) const
+    {
+        out.append(buffer.view());
+    }
+
+  private:
+    /// The formatted value.
+    inline_sink<64> buffer;
+};
+
+/// Types with a custom `sb_append` hook are measured by writing them to a `counting_sink`.
+template <typename T>
+class prepared_argument<T, std::enable_if_t
+    <
+        type_traits::has_sb_append_v<T const&>
+        and not type_traits::is_builtin_type_v<T>
+        and not type_traits::is_automatically_convertible_v<T const&>
+    >> final
+{
+  public:
+    /// Measure `value`.
+    explicit prepared_argument(T const& value)
+        : value{value}
+    {
+        counting_sink counter;
+        append_to(counter, value);
+        length = counter.size();
+    }
+
+    /// Number of characters `write` produces.
+    std::size_t size() const noexcept
+    {
+        return length;
+    }
+
+    /// Write `value` to `out`.
+    void write(sink& out) const
+    {
+        append_to(out, value);
+    }
+
+  private:
+    /// The value.
+    T const& value;
+    /// Number of characters of `value`.
+    std::size_t length{0};
+};
+
+/// Argument of `total_size` whose characters are written separately (e.g. the literal pieces of a format pattern).
+struct known_size final
+{
+    /// Number of characters.
+    std::size_t value;
+
+    /// Number of characters.
+    constexpr std::size_t size() const noexcept
+    {
+        return value;
+    }
+};
+
+/// \brief Sum of the sizes of all `arguments`.
+///
+/// \throws std::length_error if the sum is larger than `std::string::max_size()`
+template <typename... Prepared>
+std::size_t total_size(Prepared const&... arguments)
+{
+    static auto const max_size = std::string{}.max_size();
+    std::size_t total{0};
+    [[maybe_unused]] auto const add = [&total](std::size_t const size)
+    {
+        if (size > max_size - total)
+        {
+            throw std::length_error{""};
+        }
+        total += size;
+    };
+    (add(arguments.size()), ...);
+    return total;
+}
+
+/// Concatenate `arguments` with a single allocation.
+template <typename... Prepared>
+std::string concatenate(Prepared const&... arguments)
+{
+    std::string result;
+    result.reserve(total_size(arguments...));
+    string_sink out{result};
+    (arguments.write(out), ...);
+    return result;
+}
+
+}
+
+/// \brief Concatenate the string representations of all `values`.
+///
+/// The conversion rules of `append_to` are used.
+/// First the size of every converted value is determined, then the result
+/// is allocated once and all values are written into it.
+/// * string-like values (e.g. `std::string`, literals) are used without copying
+/// * `arithmetic` values are formatted into an inline buffer
+/// * values with a custom `sb_append` hook are written twice: once to measure, once to write
+/// * other values are converted with `make_string` first
+///
+/// Without values of the last kind, exactly one allocation is done
+/// (none if the result fits into the small string buffer).
+///
+/// \tparam Ts The types of the input values.
+/// \param values The values that will be concatenated.
+///
+/// \return The concatenation of all converted `values`.
+///
+/// \throws std::length_error if the size of the result would be larger than `std::string::max_size()`
+template <typename... Ts>
+std::string concat(Ts const&... values)
+{
+    return detail::concatenate(detail::prepared_argument<Ts>{values}...);
+}
+
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+/// Defined if `format` accepts string literals as pattern (C++20).
+#define BOSSWESTFALEN_SB_FIXED_STRING
+
+/// \brief Characters of a string literal that can be used as template argument (C++20).
+///
+/// Created implicitly by `format<"...">(values...)`.
+///
+/// \tparam N The number of characters including the terminating null character.
+template <std::size_t N>
+struct fixed_string final
+{
+    /// Copy the characters of `text`.
+    constexpr fixed_string(char const (&text)[N]) noexcept
+    {
+        std::copy_n(text, N, characters);
+    }
+
+    /// The characters including the terminating null character.
+    char characters[N]{};
+};
+#endif // BOSSWESTFALEN_SB_FIXED_STRING
+
+namespace detail
+{
+
+/// \brief Literal text and placeholders of a `format` pattern with `N` characters.
+///
+/// The literal pieces are stored without the placeholders, one after the other.
+template <std::size_t N>
+struct format_layout final
+{
+    /// The literal pieces, `{{` and `}}` replaced by single braces.
+    char text[N]{};
+    /// Number of characters in `text`.
+    std::size_t size{0};
+    /// `ends[i]` is the end of the literal piece in front of placeholder `i` in `text`.
+    std::size_t ends[N]{};
+    /// Number of placeholders.
+    std::size_t placeholders{0};
+    /// Whether every brace is part of a placeholder `{}` or an escaped brace.
+    bool valid{true};
+
+    /// The literal piece in front of placeholder `index`, or after the last placeholder.
+    constexpr std::string_view piece(std::size_t const index) const noexcept
+    {
+        auto const begin = index == 0 ? 0 : ends[index - 1];
+        auto const end = index == placeholders ? size : ends[index];
+        return std::string_view{text + begin, end - begin};
+    }
+};
+
+/// Split the null-terminated `pattern` into literal pieces and placeholders `{}`.
+template <std::size_t N>
+constexpr format_layout<N> parse_format(char const (&pattern)[N]) noexcept
+{
+    format_layout<N> layout{};
+    for (std::size_t i{0}; i + 1 < N; ++i)
+    {
+        auto const character = pattern[i];
+        auto const next = pattern[i + 1];
+        if (character == '{' and next == '}')
+        {
+            layout.ends[layout.placeholders++] = layout.size;
+            ++i;
+        }
+        else if ((character == '{' or character == '}') and next == character)
+        {
+            layout.text[layout.size++] = character;
+            ++i;
+        }
+        else if (character == '{' or character == '}')
+        {
+            layout.valid = false;
+        }
+        else
+        {
+            layout.text[layout.size++] = character;
+        }
+    }
+    return layout;
+}
+
+#ifdef BOSSWESTFALEN_SB_FIXED_STRING
+/// Split the pattern `pattern` into literal pieces and placeholders `{}`.
+template <std::size_t N>
+constexpr format_layout<N> parse_format(fixed_string<N> const& pattern) noexcept
+{
+    return parse_format(pattern.characters);
+}
+#endif // BOSSWESTFALEN_SB_FIXED_STRING
+
+/// The layout of `Pattern`, computed once at compile time.
+#ifdef BOSSWESTFALEN_SB_FIXED_STRING
+template <fixed_string Pattern>
+#else
+template <auto const& Pattern>
+#endif // BOSSWESTFALEN_SB_FIXED_STRING
+struct pattern_layout final
+{
+    /// The layout.
+    static constexpr auto value = parse_format(Pattern);
+};
+
+/// Write the literal pieces of `Layout` and the prepared `arguments` in turn to a string allocated once.
+template <typename Layout, std::size_t... Indices, typename... Prepared>
+std::string write_format(std::index_sequence<Indices...>, Prepared const&... arguments)
+{
+    constexpr auto const& layout = Layout::value;
+    std::string result;
+    result.reserve(total_size(known_size{layout.size}, arguments...));
+    string_sink out{result};
+    ((out.append(layout.piece(Indices)), arguments.write(out)), ...);
+    out.append(layout.piece(layout.placeholders));
+    return result;
+}
+
+/// Check `Layout` against the values and write them (see `format`).
+template <typename Layout, typename... Ts>
+std::string format_pattern(Ts const&... values)
+{
+    static_assert(Layout::value.valid, "format pattern contains a single { or }, use {{ and }} for braces");
+    static_assert(Layout::value.placeholders == sizeof...(Ts), "number of values does not match the number of {} in the format pattern");
+    return write_format<Layout>(std::index_sequence_for<Ts...>{}, prepared_argument<Ts>{values}...);
+}
+
+}
+
+#ifdef BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+/// \brief Replace every `{}` in `Pattern` with the next value, e.g. `format<"user={} ms={}">(id, ms)`.
+///
+/// The pattern is parsed at compile time: its literal pieces and their total length are constants,
+/// and the number of `values` is checked against the number of `{}` with a `static_assert`.
+/// Use `{{` and `}}` for literal braces.
+/// The values are converted like in `concat` and the result is allocated once.
+///
+/// String literals can be used as pattern since C++20 (see `BOSSWESTFALEN_SB_FIXED_STRING`).
+/// In C++17 the pattern is a `constexpr` character array with static storage duration:
+/// \code
+/// static constexpr char pattern[]{"user={} action={} ms={}"};
+/// auto const message = format<pattern>(id, name, ms);
+/// \endcode
+///
+/// \return The pattern with the converted values in place of the `{}`.
+///
+/// \throws std::length_error if the size of the result would be larger than `std::string::max_size()`
+template <auto const& Pattern, typename... Ts>
+std::string format(Ts const&... values);
+#elif defined(BOSSWESTFALEN_SB_FIXED_STRING)
+template <fixed_string Pattern, typename... Ts>
+std::string format(Ts const&... values)
+{
+    return detail::format_pattern<detail::pattern_layout<Pattern>>(values...);
+}
+#else
+template <auto const& Pattern, typename... Ts>
+std::string format(Ts const&... values)
+{
+    return detail::format_pattern<detail::pattern_layout<Pattern>>(values...);
+}
+#endif // BOSSWESTFALEN_ONLY_FOR_DOXYGEN
+
+
+/// \brief Elements of a range with separators, created by `join()`.
+///
+/// Written with an `sb_append` hook, so it can be used with `make_string`, `concat`, and `add`.
+/// Only a reference to the range is stored.
+///
+/// \tparam Range The type of the range.
+template <typename Range>
+struct joined_range final
+{
+    /// The elements.
+    Range const& range;
+    /// Written between two elements.
+    std::string_view separator;
+    /// Written before the first element.
+    std::string_view prefix;
+    /// Written after the last element.
+    std::string_view suffix;
+};
+
+/// \brief Join the elements of `range` with `separator`, e.g. `sb.add(join(tags, ", ", "[", "]"))`.
+///
+/// Every element is written according to the rules of `append_to`. Elements without
+/// such a conversion are written as follows:
+/// * pairs (e.g. elements of a `std::map`) as *first*`=`*second*
+/// * ranges with the same `separator`, `prefix`, and `suffix`, e.g. `[[1, 2], [3]]`
+///
+/// \param range The elements; must outlive the result.
+/// \param separator Written between two elements.
+/// \param prefix Written before the first element.
+/// \param suffix Written after the last element.
+template <typename Range>
+joined_range<Range> join(Range const& range, std::string_view const separator,
+                         std::string_view const prefix = {}, std::string_view const suffix = {}) noexcept
+{
+    return joined_range<Range>{range, separator, prefix, suffix};
+}
+
+namespace detail
+{
+
+template <typename Element, typename Format>
+void append_element(sink& out, Element const& element, Format const& format);
+
+/// Write the elements of `range` formatted like `format`.
+template <typename Range, typename Format>
+void append_joined(sink& out, Range const& range, Format const& format)
+{
+    out.append(format.prefix);
+    auto first = true;
+    for (auto const& element : range)
+    {
+        if (not first)
+        {
+            out.append(format.separator);
+        }
+        first = false;
+        append_element(out, element, format);
+    }
+    out.append(format.suffix);
+}
+
+/// Write a single element of a `joined_range`.
+template <typename Element, typename Format>
+void append_element(sink& out, Element const& element, Format const& format)
+{
+    if constexpr (type_traits::has_sb_append_v<Element const&>
+                  or type_traits::has_external_to_string_v<Element const&>
+                  or type_traits::has_stream_operator_v<Element const&>)
+    {
+        append_to(out, element);
+    }
+    else if constexpr (type_traits::is_pair<Element>::value)
+    {
+        append_element(out, element.first, format);
+        out.push_back('=');
+        append_element(out, element.second, format);
+    }
+    else
+    {
+        static_assert(type_traits::is_range<Element>::value, "element cannot be converted");
+        append_joined(out, element, format);
+    }
+}
+
+/// \brief Size of the result of writing `joined`, if it can be computed cheaply.
+///
+/// \return The exact size for ranges of string-like elements, 0 otherwise.
+template <typename Range>
+std::size_t joined_size(joined_range<Range> const& joined)
+{
+    using element_type = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(joined.range))>>;
+    if constexpr (std::is_convertible_v<element_type const&, std::string_view>)
+    {
+        std::size_t size{joined.prefix.size() + joined.suffix.size()};
+        std::size_t count{0};
+        for (auto const& element : joined.range)
+        {
+            size += std::string_view{element}.size();
+            ++count;
+        }
+        return count == 0 ? size : size + (count - 1) * joined.separator.size();
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+}
+
+/// `sb_append` hook for `joined_range`.
+template <typename Range>
+void sb_append(sink& out, joined_range<Range> const& joined)
+{
+    detail::append_joined(out, joined.range, joined);
+}
+
+
+/// Rules for escaping text (see `escaped()`).
+enum class escape_mode
+{
+    /// Content of a JSON string: `"`, `\`, and control characters are escaped with `\`.
+    json,
+    /// HTML text or attribute value: `&`, `<`, `>`, `"`, and `'` are replaced by character references.
+    html,
+    /// CSV field (RFC 4180): quoted if it contains `"`, `,`, CR, or LF; quotes are doubled.
+    csv,
+    /// Word for a POSIX shell: always single-quoted, `'` is written as `'\''`.
+    shell
+};
+
+/// \brief A value whose text is escaped when it is written, created by `escaped()`.
+///
+/// Written with an `sb_append` hook, so it can be used with `make_string`, `concat`, and `add`.
+/// Only a reference to the value is stored.
+///
+/// \tparam Mode The rules for escaping.
+/// \tparam T The type of the value.
+template <escape_mode Mode, typename T>
+struct escaped_value final
+{
+    /// The value.
+    T const& value;
+};
+
+/// \brief Escape the text of `value` according to `Mode`, e.g. `sb.add(escaped<escape_mode::html>(name))`.
+///
+/// `value` is converted according to the rules of `append_to`; string-like values are used directly.
+/// Runs of characters that need no escaping are found with SIMD instructions if available
+/// (see `BOSSWESTFALEN_SB_SSE2`) and copied in one piece.
+///
+/// \param value The value; must outlive the result.
+template <escape_mode Mode, typename T>
+escaped_value<Mode, T> escaped(T const& value) noexcept
+{
+    return escaped_value<Mode, T>{value};
+}
+
+/// Escape `value` for the content of a JSON string (see `escape_mode::json`).
+template <typename T>
+escaped_value<escape_mode::json, T> json_escaped(T const& value) noexcept
+{
+    return escaped<escape_mode::json>(value);
+}
+
+/// Escape `value` for HTML text or an attribute value (see `escape_mode::html`).
+template <typename T>
+escaped_value<escape_mode::html, T> html_escaped(T const& value) noexcept
+{
+    return escaped<escape_mode::html>(value);
+}
+
+/// Escape `value` for a CSV field (see `escape_mode::csv`).
+template <typename T>
+escaped_value<escape_mode::csv, T> csv_escaped(T const& value) noexcept
+{
+    return escaped<escape_mode::csv>(value);
+}
+
+/// Quote `value` as a single word for a POSIX shell (see `escape_mode::shell`).
+template <typename T>
+escaped_value<escape_mode::shell, T> shell_escaped(T const& value) noexcept
+{
+    return escaped<escape_mode::shell>(value);
+}
+
+namespace detail
+{
+
+/// \brief Characters that need escaping in mode `Mode`.
+///
+/// `special` lists single characters; if `control` is true, all characters below 0x20 are added.
+/// For `escape_mode::csv` these are the characters that require quoting.
+template <escape_mode Mode>
+struct escape_rules;
+
+template <>
+struct escape_rules<escape_mode::json>
+{
+    static constexpr char special[]{'"', '\\'};
+    static constexpr bool control{true};
+};
+
+template <>
+struct escape_rules<escape_mode::html>
+{
+    static constexpr char special[]{'&', '<', '>', '"', '\''};
+    static constexpr bool control{false};
+};
+
+template <>
+struct escape_rules<escape_mode::csv>
+{
+    static constexpr char special[]{'"', ',', '\r', '\n'};
+    static constexpr bool control{false};
+};
+
+template <>
+struct escape_rules<escape_mode::shell>
+{
+    static constexpr char special[]{'\''};
+    static constexpr bool control{false};
+};
+
+/// Table of `escape_rules<Mode>`, indexed by `unsigned char`.
+template <escape_mode Mode>
+constexpr std::array<bool, 256> make_escape_table() noexcept
+{
+    using rules = escape_rules<Mode>;
+    std::array<bool, 256> table{};
+    if (rules::control)
+    {
+        for (std::size_t i{0}; i < 0x20; ++i)
+        {
+            table[i] = true;
+        }
+    }
+    for (auto const special : rules::special)
+    {
+        table[static_cast<unsigned char>(special)] = true;
+    }
+    return table;
+}
+
+/// Whether a character needs escaping in mode `Mode`, indexed by `unsigned char`.
+template <escape_mode Mode>
+inline constexpr auto escape_table = make_escape_table<Mode>();
+
+/// Index of the first character of `text` that needs escaping in mode `Mode`, or `text.size()`.
+template <escape_mode Mode>
+std::size_t find_escape_scalar(std::string_view const text) noexcept
+{
+    for (std::size_t i{0}; i < text.size(); ++i)
+    {
+        if (escape_table<Mode>[static_cast<unsigned char>(text[i])])
+        {
+            return i;
+        }
+    }
+    return text.size();
+}
+
+#ifdef BOSSWESTFALEN_SB_SSE2
+/// Bytes of `block` that need escaping in mode `Mode` are 0xff, all others 0.
+template <escape_mode Mode>
+__m128i escape_mask(__m128i const block) noexcept
+{
+    using rules = escape_rules<Mode>;
+    auto mask = _mm_setzero_si128();
+    if constexpr (rules::control)
+    {
+        // unsigned comparison: min(x, 0x1f) == x is x < 0x20
+        mask = _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(0x1f)), block);
+    }
+    for (auto const special : rules::special)
+    {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(block, _mm_set1_epi8(special)));
+    }
+    return mask;
+}
+#endif // BOSSWESTFALEN_SB_SSE2
+
+#ifdef BOSSWESTFALEN_SB_AVX2
+/// Bytes of `block` that need escaping in mode `Mode` are 0xff, all others 0.
+template <escape_mode Mode>
+__m256i escape_mask(__m256i const block) noexcept
+{
+    using rules = escape_rules<Mode>;
+    auto mask = _mm256_setzero_si256();
+    if constexpr (rules::control)
+    {
+        mask = _mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8(0x1f)), block);
+    }
+    for (auto const special : rules::special)
+    {
+        mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(special)));
+    }
+    return mask;
+}
+#endif // BOSSWESTFALEN_SB_AVX2
+
+/// \brief Index of the first character of `text` that needs escaping in mode `Mode`, or `text.size()`.
+///
+/// Checks 32 (AVX2) or 16 (SSE2) characters at once if available;
+/// the rest is checked by `find_escape_scalar()`.
+template <escape_mode Mode>
+std::size_t find_escape(std::string_view const text) noexcept
+{
+    std::size_t index{0};
+#ifdef BOSSWESTFALEN_SB_AVX2
+    for (; text.size() - index >= 32; index += 32)
+    {
+        auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(text.data() + index));
+        auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(escape_mask<Mode>(block)));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif // BOSSWESTFALEN_SB_AVX2
+#ifdef BOSSWESTFALEN_SB_SSE2
+    for (; text.size() - index >= 16; index += 16)
+    {
+        auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(text.data() + index));
+        auto const mask = static_cast<unsigned>(_mm_movemask_epi8(escape_mask<Mode>(block)));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif // BOSSWESTFALEN_SB_SSE2
+    return index + find_escape_scalar<Mode>(text.substr(index));
+}
+
+/// \brief Replacement of `character`, which needs escaping in mode `Mode` (not `escape_mode::csv`).
+///
+/// \param buffer Storage for replacements that are not constant.
+template <escape_mode Mode>
+std::string_view escape_sequence(char const character, [[maybe_unused]] char (&buffer)[6]) noexcept
+{
+    if constexpr (Mode == escape_mode::json)
+    {
+        switch (character)
+        {
+            case '"':
+                return "\\\"";
+            case '\\':
+                return "\\\\";
+            case '\b':
+                return "\\b";
+            case '\f':
+                return "\\f";
+            case '\n':
+                return "\\n";
+            case '\r':
+                return "\\r";
+            case '\t':
+                return "\\t";
+            default:
+                break;
+        }
+        constexpr char digits[]{"0123456789abcdef"};
+        auto const code = static_cast<unsigned char>(character);
+        buffer[0] = '\\';
+        buffer[1] = 'u';
+        buffer[2] = '0';
+        buffer[3] = '0';
+        buffer[4] = digits[code >> 4];
+        buffer[5] = digits[code & 0xf];
+        return std::string_view{buffer, 6};
+    }
+    else if constexpr (Mode == escape_mode::html)
+    {
+        switch (character)
+        {
+            case '&':
+                return "&amp;";
+            case '<':
+                return "&lt;";
+            case '>':
+                return "&gt;";
+            case '"':
+                return "&quot;";
+            default:
+                return "&#39;";
+        }
+    }
+    else
+    {
+        static_assert(Mode == escape_mode::shell, "CSV fields are quoted as a whole");
+        return "'\\''";
+    }
+}
+
+/// Number of characters `append_escaped<Mode>()` writes for `text`.
+template <escape_mode Mode>
+std::size_t escaped_size(std::string_view text) noexcept
+{
+    if constexpr (Mode == escape_mode::csv)
+    {
+        if (find_escape<Mode>(text) == text.size())
+        {
+            return text.size();
+        }
+        return text.size() + 2 + static_cast<std::size_t>(std::count(std::cbegin(text), std::cend(text), '"'));
+    }
+    else
+    {
+        std::size_t size{Mode == escape_mode::shell ? 2u : 0u};
+        char buffer[6];
+        for (auto index = find_escape<Mode>(text); index != text.size(); index = find_escape<Mode>(text))
+        {
+            size += index + escape_sequence<Mode>(text[index], buffer).size();
+            text.remove_prefix(index + 1);
+        }
+        return size + text.size();
+    }
+}
+
+/// Write `text` escaped according to `Mode` to `out`.
+template <escape_mode Mode>
+void append_escaped(sink& out, std::string_view text)
+{
+    if constexpr (Mode == escape_mode::csv)
+    {
+        if (find_escape<Mode>(text) == text.size())
+        {
+            out.append(text);
+            return;
+        }
+        out.push_back('"');
+        for (auto index = text.find('"'); index != std::string_view::npos; index = text.find('"'))
+        {
+            // the quote is written twice
+            out.append(text.data(), index + 1);
+            out.push_back('"');
+            text.remove_prefix(index + 1);
+        }
+        out.append(text);
+        out.push_back('"');
+    }
+    else
+    {
+        if constexpr (Mode == escape_mode::shell)
+        {
+            out.push_back('\'');
+        }
+        char buffer[6];
+        for (auto index = find_escape<Mode>(text); index != text.size(); index = find_escape<Mode>(text))
+        {
+            out.append(text.data(), index);
+            out.append(escape_sequence<Mode>(text[index], buffer));
+            text.remove_prefix(index + 1);
+        }
+        out.append(text);
+        if constexpr (Mode == escape_mode::shell)
+        {
+            out.push_back('\'');
+        }
+    }
+}
+
+}
+
+/// `sb_append` hook for `escaped_value`.
+template <escape_mode Mode, typename T>
+void sb_append(sink& out, escaped_value<Mode, T> const& value)
+{
+    if constexpr (std::is_convertible_v<T const&, std::string_view>)
+    {
+        detail::append_escaped<Mode>(out, std::string_view{value.value});
+    }
+    else
+    {
+        detail::inline_sink<256> text;
+        append_to(text, value.value);
+        detail::append_escaped<Mode>(out, text.view());
+    }
+}
+
+namespace detail
+{
+
+/// \brief Expected number of characters of `value` after conversion.
+///
+/// \return The exact size if it can be computed without converting `value`, 0 otherwise.
+template <typename T>
+std::size_t size_hint(T const&) noexcept
+{
+    return 0;
+}
+
+/// The size of a `joined_range` (see `joined_size()`).
+template <typename Range>
+std::size_t size_hint(joined_range<Range> const& joined)
+{
+    return joined_size(joined);
+}
+
+/// The size of an `escaped_value` of a string-like value.
+template <escape_mode Mode, typename T>
+std::size_t size_hint(escaped_value<Mode, T> const& value) noexcept
+{
+    if constexpr (std::is_convertible_v<T const&, std::string_view>)
+    {
+        return escaped_size<Mode>(std::string_view{value.value});
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+}
+
+
+/// \brief Storage that writes fragments into large contiguous chunks.
+///
+/// Instead of one heap allocated string per fragment, the characters of all
+/// fragments are appended to chunks of `initial_chunk_size` up to `maximal_chunk_size`
+/// bytes (chunks grow geometrically).
+/// Per fragment only its position inside a chunk is stored.
+/// Fragments larger than a chunk get a chunk of their own.
+///
+/// Consecutive fragments are usually adjacent in memory,
+/// so concatenation boils down to one copy per chunk.
+///
+/// Fragments can also be added at the front (see `prepend()`);
+/// their characters are stored in the chunks as well.
+///
+/// \tparam String The string type fragments are converted to.
+///     Its size limit and its allocator are used.
+///
+/// \note `chunked_storage` is not thread-safe.
+template <typename String>
+class chunked_storage final
+{
+  public:
+    /// Type used for sizes.
+    using size_type = typename String::size_type;
+    /// Allocator used for chunks and bookkeeping.
+    using allocator_type = typename String::allocator_type;
+
+    /// Capacity of the first chunk.
+    static constexpr size_type initial_chunk_size{4 * 1024};
+    /// Capacity chunks grow to at most (unless a single fragment is larger).
+    static constexpr size_type maximal_chunk_size{64 * 1024};
+
+    /// \brief Forward iterator over the fragments in order, yields `std::string_view`.
+    ///
+    /// Fragments that are adjacent in memory are merged into one segment (like `for_each_segment()`),
+    /// empty fragments are skipped.
+    class const_iterator final
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        /// Default Ctor is sufficient.
+        const_iterator() = default;
+
+        /// Refer to the segment starting with the fragment with `index` of `storage`.
+        const_iterator(chunked_storage const& storage, std::size_t const index) noexcept
+            : storage{&storage}
+            , first{index}
+            , next{index}
+        {
+            merge();
+        }
+
+        /// The segment.
+        std::string_view operator*() const noexcept
+        {
+            return segment;
+        }
+
+        /// Go to the next segment.
+        const_iterator& operator++() noexcept
+        {
+            first = next;
+            merge();
+            return *this;
+        }
+
+        /// Go to the next segment, return the previous position.
+        const_iterator operator++(int) noexcept
+        {
+            auto const previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        /// Check whether both refer to the same segment.
+        friend bool operator==(const_iterator const& lhs, const_iterator const& rhs) noexcept
+        {
+            return lhs.first == rhs.first;
+        }
+
+        /// Check whether both refer to different segments.
+        friend bool operator!=(const_iterator const& lhs, const_iterator const& rhs) noexcept
+        {
+            return not (lhs == rhs);
+        }
+
+      private:
+        /// The storage of the fragments.
+        chunked_storage const* storage{nullptr};
+        /// Index of the first fragment of `segment`.
+        std::size_t first{0};
+        /// Index of the fragment after `segment`.
+        std::size_t next{0};
+        /// The current segment.
+        std::string_view segment{};
+
+        /// Merge the fragments starting at `next` that are adjacent in memory into `segment`.
+        void merge() noexcept
+        {
+            segment = std::string_view{};
+            for (; next < storage->size(); ++next)
+            {
+                auto const fragment = storage->fragment(next);
+                if (segment.empty())
+                {
+                    segment = fragment;
+                }
+                else if (fragment.data() == segment.data() + segment.size())
+                {
+                    segment = std::string_view{segment.data(), segment.size() + fragment.size()};
+                }
+                else if (not fragment.empty())
+                {
+                    return;
+                }
+            }
+        }
+    };
+
+    /// Default Ctor does not allocate.
+    chunked_storage() = default;
+
+    /// Use `allocator` for all memory; does not allocate.
+    explicit chunked_storage(allocator_type const& allocator)
+        : chunks{chunk_allocator{allocator}}
+        , fragments{fragment_allocator{allocator}}
+        , prefixes{fragment_allocator{allocator}}
+    {
+    }
+
+    /// \brief Copy all fragments into a single new chunk.
+    ///
+    /// The allocator is selected like for standard containers.
+    chunked_storage(chunked_storage const& other)
+        : chunked_storage{other, std::allocator_traits<allocator_type>::select_on_container_copy_construction(
+              other.get_allocator())}
+    {
+    }
+
+    /// Copy all fragments into a single new chunk allocated with `allocator`.
+    chunked_storage(chunked_storage const& other, allocator_type const& allocator)
+        : chunked_storage{allocator}
+    {
+        size_type total{0};
+        other.for_each_fragment([&total](std::string_view const fragment)
+        {
+            total += fragment.size();
+        });
+        fragments.reserve(other.size());
+        reserve(total);
+        other.for_each_fragment([this](std::string_view const fragment)
+        {
+            std::copy(std::cbegin(fragment), std::cend(fragment), cursor);
+            fragments.emplace_back(cursor, fragment.size());
+            cursor += fragment.size();
+        });
+    }
+
+    /// Take over the chunks of `other`, which is empty afterwards.
+    chunked_storage(chunked_storage&& other) noexcept
+        : chunks{std::move(other.chunks)}
+        , fragments{std::move(other.fragments)}
+        , prefixes{std::move(other.prefixes)}
+        , cursor{std::exchange(other.cursor, nullptr)}
+        , end{std::exchange(other.end, nullptr)}
+        , used_chunks{std::exchange(other.used_chunks, 0)}
+    {
+        other.chunks.clear();
+        other.fragments.clear();
+        other.prefixes.clear();
+    }
+
+    /// Copy-and-swap, the allocator is kept.
+    chunked_storage& operator=(chunked_storage const& other)
+    {
+        if (this != &other)
+        {
+            chunked_storage{other, get_allocator()}.swap(*this);
+        }
+        return *this;
+    }
+
+    /// Take over the chunks of `other` if the allocators are equal, otherwise copy them.
+    chunked_storage& operator=(chunked_storage&& other)
+        noexcept(std::allocator_traits<allocator_type>::is_always_equal::value)
+    {
+        if (get_allocator() == other.get_allocator())
+        {
+            chunked_storage{std::move(other)}.swap(*this);
+        }
+        else
+        {
+            chunked_storage{other, get_allocator()}.swap(*this);
+            other.clear();
+        }
+        return *this;
+    }
+
+    /// Release all chunks.
+    ~chunked_storage()
+    {
+        release();
+    }
+
+    /// The allocator used for all memory.
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type{chunks.get_allocator()};
+    }
+
+    /// \brief Exchange the content with `other`.
+    ///
+    /// \pre The allocators compare equal (as for standard containers).
+    void swap(chunked_storage& other) noexcept
+    {
+        assert(get_allocator() == other.get_allocator());
+        using std::swap;
+        swap(chunks, other.chunks);
+        swap(fragments, other.fragments);
+        swap(prefixes, other.prefixes);
+        swap(cursor, other.cursor);
+        swap(end, other.end);
+        swap(used_chunks, other.used_chunks);
+    }
+
+    /// \brief Store a new fragment.
+    ///
+    /// \param writer Callable that writes the fragment to the `sink&` it receives.
+    /// \param size_hint Expected size of the fragment.
+    ///     If it is exact, the fragment is written without moving any bytes.
+    ///
+    /// \return The size of the new fragment.
+    ///
+    /// \throws any exception thrown by `writer` or during allocation.
+    ///     The storage is unchanged in this case (strong guarantee).
+    template <typename Writer>
+    size_type append(Writer&& writer, size_type const size_hint = 0)
+    {
+        grow(fragments);
+        reserve(size_hint);
+
+        chunk_sink out{*this};
+        try
+        {
+            writer(static_cast<sink&>(out));
+        }
+        catch (...)
+        {
+            cursor = out.start;
+            throw;
+        }
+        auto const size = static_cast<size_type>(cursor - out.start);
+        fragments.emplace_back(out.start, size);
+        return size;
+    }
+
+    /// \brief Store a new fragment without copying its characters.
+    ///
+    /// Only `view` itself is stored, the characters it refers to must stay valid
+    /// as long as they are used (e.g. until the last call to `build()`).
+    /// A copy of the storage copies the characters.
+    ///
+    /// \return The size of the new fragment.
+    size_type append_view(std::string_view const view)
+    {
+        grow(fragments);
+        fragments.push_back(view);
+        return view.size();
+    }
+
+    /// \brief Store a new fragment in front of all other fragments.
+    ///
+    /// See `append()`.
+    template <typename Writer>
+    size_type prepend(Writer&& writer, size_type const size_hint = 0)
+    {
+        grow(prefixes);
+        auto const size = append(std::forward<Writer>(writer), size_hint);
+        prefixes.push_back(fragments.back());
+        fragments.pop_back();
+        return size;
+    }
+
+    /// \brief Store `view` in front of all other fragments without copying its characters.
+    ///
+    /// See `append_view()`.
+    size_type prepend_view(std::string_view const view)
+    {
+        grow(prefixes);
+        prefixes.push_back(view);
+        return view.size();
+    }
+
+    /// \brief Store a new fragment of `size` characters `fill` that can be changed later.
+    ///
+    /// \return The characters of the new fragment.
+    ///     They stay valid until the storage is cleared or destroyed (also if it is moved).
+    char* append_slot(size_type const size, char const fill)
+    {
+        grow(fragments);
+        reserve(size);
+        auto const data = cursor;
+        std::fill_n(data, size, fill);
+        fragments.emplace_back(data, size);
+        cursor += size;
+        return data;
+    }
+
+    /// \brief Move all fragments of `other` behind the fragments of this storage; `other` is empty afterwards.
+    ///
+    /// The chunks of `other` are taken over, so no characters are copied.
+    /// Fragments of `other` that refer to characters outside its chunks (see `append_view()`) stay references.
+    /// If the allocators differ, the fragments of `other` are copied into one new fragment instead.
+    ///
+    /// \param other The storage whose fragments are moved.
+    /// \param may_copy Whether the fragments of `other` may be copied into one new fragment
+    ///     if they fit into the free space of the current chunk. This is cheaper than keeping
+    ///     the mostly empty chunks of `other`, but pointers to the characters of `other` become invalid.
+    ///
+    /// \throws any exception during allocation.
+    ///     Both storages are unchanged in this case (strong guarantee).
+    void splice(chunked_storage& other, bool const may_copy = false)
+    {
+        assert(this != &other);
+        size_type total{0};
+        other.for_each_fragment([&total](std::string_view const fragment)
+        {
+            total += fragment.size();
+        });
+        if (get_allocator() != other.get_allocator() or (may_copy and total <= static_cast<size_type>(end - cursor)))
+        {
+            append([&other](sink& out)
+            {
+                other.for_each_fragment([&out](std::string_view const fragment)
+                {
+                    out.append(fragment);
+                });
+            }, total);
+            other.reset(std::numeric_limits<size_type>::max());
+            return;
+        }
+
+        grow(fragments, other.size());
+        grow(chunks, other.chunks.size());
+        other.for_each_fragment([this](std::string_view const fragment)
+        {
+            fragments.push_back(fragment);
+        });
+        // the chunks of `other` that contain fragments go before the current chunk, the others are kept for reuse
+        auto const used = std::next(std::cbegin(other.chunks), static_cast<std::ptrdiff_t>(other.used_chunks));
+        chunks.insert(std::next(std::cbegin(chunks), static_cast<std::ptrdiff_t>(used_chunks == 0 ? 0 : used_chunks - 1)),
+                      std::cbegin(other.chunks), used);
+        chunks.insert(std::cend(chunks), used, std::cend(other.chunks));
+        used_chunks += other.used_chunks;
+
+        other.chunks.clear();
+        other.fragments.clear();
+        other.prefixes.clear();
+        other.cursor = nullptr;
+        other.end = nullptr;
+        other.used_chunks = 0;
+    }
+
+    /// Remove the fragment that was added last.
+    void pop_back()
+    {
+        assert(not fragments.empty());
+        release_bytes(fragments.back());
+        fragments.pop_back();
+    }
+
+    /// Remove the fragment that was prepended last.
+    void pop_front()
+    {
+        assert(not prefixes.empty());
+        release_bytes(prefixes.back());
+        prefixes.pop_back();
+    }
+
+    /// Check whether no fragments are stored.
+    bool empty() const noexcept
+    {
+        return fragments.empty() and prefixes.empty();
+    }
+
+    /// Number of stored fragments.
+    std::size_t size() const noexcept
+    {
+        return prefixes.size() + fragments.size();
+    }
+
+    /// The maximal size of a string built from this storage.
+    size_type max_size() const noexcept
+    {
+        return String{}.max_size();
+    }
+
+    /// The fragment with `index` (prepended fragments first).
+    std::string_view fragment(std::size_t const index) const noexcept
+    {
+        assert(index < size());
+        return index < prefixes.size()
+            ? prefixes[prefixes.size() - 1 - index]
+            : fragments[index - prefixes.size()];
+    }
+
+    /// Iterator to the first segment of fragments.
+    const_iterator begin_fragments() const noexcept
+    {
+        return const_iterator{*this, 0};
+    }
+
+    /// Iterator behind the last segment of fragments.
+    const_iterator end_fragments() const noexcept
+    {
+        return const_iterator{*this, size()};
+    }
+
+    /// Number of allocated chunks, including the chunks kept by `reset()`.
+    std::size_t chunk_count() const noexcept
+    {
+        return chunks.size();
+    }
+
+    /// Remove all fragments and release the chunks.
+    void clear() noexcept
+    {
+        chunked_storage{get_allocator()}.swap(*this);
+    }
+
+    /// \brief Remove all fragments, but keep memory for new fragments.
+    ///
+    /// Chunks are kept in the order they were allocated as long as their total capacity
+    /// does not exceed `retained_capacity`, the others are released.
+    /// New fragments are written to the kept chunks before new chunks are allocated.
+    /// The lists of fragments keep their capacity.
+    ///
+    /// \param retained_capacity Maximal number of bytes in the kept chunks.
+    void reset(size_type const retained_capacity) noexcept
+    {
+        fragments.clear();
+        prefixes.clear();
+        size_type total{0};
+        auto kept = std::cbegin(chunks);
+        for (; kept != std::cend(chunks) and kept->capacity <= retained_capacity - total; ++kept)
+        {
+            total += kept->capacity;
+        }
+        char_allocator allocator{chunks.get_allocator()};
+        std::for_each(kept, std::cend(chunks), [&allocator](chunk const& released)
+        {
+            std::allocator_traits<char_allocator>::deallocate(allocator, released.data, released.capacity);
+        });
+        chunks.erase(kept, std::cend(chunks));
+        cursor = nullptr;
+        end = nullptr;
+        used_chunks = 0;
+    }
+
+    /// \brief Call `function` with consecutive `std::string_view` segments of the fragments.
+    ///
+    /// Fragments that are adjacent in memory are merged into one segment.
+    ///
+    /// \param function Callable that receives the segments.
+    /// \param first_fragment Index of the first fragment to use.
+    template <typename Function>
+    void for_each_segment(Function&& function, std::size_t const first_fragment = 0) const
+    {
+        assert(first_fragment <= size());
+        char const* data{nullptr};
+        size_type count{0};
+        for_each_fragment([&function, &data, &count](std::string_view const fragment)
+        {
+            if (fragment.data() == data + count)
+            {
+                count += fragment.size();
+                return;
+            }
+            if (count != 0)
+            {
+                function(std::string_view{data, count});
+            }
+            data = fragment.data();
+            count = fragment.size();
+        }, first_fragment);
+        if (count != 0)
+        {
+            function(std::string_view{data, count});
+        }
+    }
+
+  private:
+    /// A chunk of memory fragments are written to.
+    struct chunk final
+    {
+        /// The memory, allocated with `char_allocator`.
+        char* data;
+        /// Number of bytes in `data`.
+        size_type capacity;
+    };
+
+    /// `allocator_type` for the characters.
+    using char_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<char>;
+    /// `allocator_type` for `chunks`.
+    using chunk_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<chunk>;
+    /// `allocator_type` for `fragments`.
+    using fragment_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::string_view>;
+
+    /// `sink` writing the current fragment to the free space of the current chunk.
+    class chunk_sink final : public sink
+    {
+      public:
+        explicit chunk_sink(chunked_storage& storage) noexcept
+            : storage{storage}
+            , start{storage.cursor}
+        {
+        }
+
+        /// Storage written to.
+        chunked_storage& storage;
+        /// Begin of the fragment that is written.
+        char* start;
+
+      private:
+        void do_append(char const* data, std::size_t count) override
+        {
+            if (count > static_cast<std::size_t>(storage.end - storage.cursor))
+            {
+                // move the bytes written so far, so that the fragment stays contiguous
+                auto const written = static_cast<size_type>(storage.cursor - start);
+                auto const old_start = start;
+                storage.add_chunk(written + count);
+                std::copy(old_start, old_start + written, storage.cursor);
+                start = storage.cursor;
+                storage.cursor += written;
+            }
+            std::copy(data, data + count, storage.cursor);
+            storage.cursor += count;
+        }
+    };
+
+    /// All allocated chunks; the chunk before index `used_chunks` is the current one.
+    std::vector<chunk, chunk_allocator> chunks{};
+    /// All appended fragments in order.
+    std::vector<std::string_view, fragment_allocator> fragments{};
+    /// All prepended fragments in reverse order (i.e. the first fragment is the last one).
+    std::vector<std::string_view, fragment_allocator> prefixes{};
+    /// Begin of the free space in the current chunk.
+    char* cursor{nullptr};
+    /// End of the current chunk.
+    char* end{nullptr};
+    /// Number of chunks that contain fragments; the chunks after them are kept by `reset()` for reuse.
+    std::size_t used_chunks{0};
+
+    /// Call `function` with every fragment in order, starting at index `first_fragment`.
+    template <typename Function>
+    void for_each_fragment(Function&& function, std::size_t const first_fragment = 0) const
+    {
+        for (auto index = first_fragment; index < prefixes.size(); ++index)
+        {
+            function(prefixes[prefixes.size() - 1 - index]);
+        }
+        auto const skip = first_fragment > prefixes.size() ? first_fragment - prefixes.size() : 0;
+        std::for_each(std::next(std::cbegin(fragments), static_cast<std::ptrdiff_t>(skip)), std::cend(fragments), function);
+    }
+
+    /// Reuse the characters of `fragment` if it is the last one written to the current chunk.
+    void release_bytes(std::string_view const fragment) noexcept
+    {
+        if (fragment.data() + fragment.size() == cursor)
+        {
+            cursor -= fragment.size();
+        }
+    }
+
+    /// Make sure that `count` more elements can be added to `vector` without reallocation.
+    template <typename Vector>
+    static void grow(Vector& vector, std::size_t const count = 1)
+    {
+        if (count > vector.capacity() - vector.size())
+        {
+            vector.reserve(std::max<std::size_t>({8, vector.capacity() * 2, vector.size() + count}));
+        }
+    }
+
+    /// Make sure that `size` bytes are available in the current chunk.
+    void reserve(size_type const size)
+    {
+        if (size > static_cast<size_type>(end - cursor))
+        {
+            add_chunk(size);
+        }
+    }
+
+    /// \brief Make a chunk that can hold at least `size` bytes the current one.
+    ///
+    /// The next chunk kept by `reset()` is reused if it is large enough,
+    /// otherwise a new chunk is allocated and inserted before the kept ones.
+    void add_chunk(size_type const size)
+    {
+        if (used_chunks == chunks.size() or chunks[used_chunks].capacity < size)
+        {
+            auto capacity = used_chunks == 0
+                ? initial_chunk_size
+                : std::min(maximal_chunk_size, chunks[used_chunks - 1].capacity * 2);
+            capacity = std::max(capacity, size);
+            grow(chunks);
+            char_allocator allocator{chunks.get_allocator()};
+            chunks.push_back(chunk{std::allocator_traits<char_allocator>::allocate(allocator, capacity), capacity});
+            std::rotate(std::next(std::begin(chunks), static_cast<std::ptrdiff_t>(used_chunks)),
+                        std::prev(std::end(chunks)), std::end(chunks));
+        }
+        auto const& current = chunks[used_chunks++];
+        cursor = current.data;
+        end = cursor + current.capacity;
+    }
+
+    /// Deallocate all chunks.
+    void release() noexcept
+    {
+        char_allocator allocator{chunks.get_allocator()};
+        for (auto const& chunk : chunks)
+        {
+            std::allocator_traits<char_allocator>::deallocate(allocator, chunk.data, chunk.capacity);
+        }
+        chunks.clear();
+        used_chunks = 0;
+    }
+};
+
+
+namespace detail
+{
+
+/// The type of the strings stored in `Storage`, i.e. `String` for `Storage = Cont<String, ...>`.
+template <typename Storage>
+struct stored_string
+{
+    /// `std::string` if `Storage` is no template.
+    using type = std::string;
+};
+
+/// The type of the strings stored in `Cont<String, ...>`.
+template <template <typename...> typename Cont, typename String, typename... Rest>
+struct stored_string<Cont<String, Rest...>>
+{
+    /// The first template argument.
+    using type = String;
+};
+
+/// \brief Forward iterator adapting an iterator over strings to yield `std::string_view`.
+///
+/// \tparam Iterator Iterator over the stored strings of a container.
+template <typename Iterator>
+class view_iterator final
+{
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    /// Default Ctor is sufficient.
+    view_iterator() = default;
+
+    /// Refer to the string at `position`.
+    explicit view_iterator(Iterator const position)
+        : position{position}
+    {
+    }
+
+    /// View of the string.
+    std::string_view operator*() const
+    {
+        return std::string_view{*position};
+    }
+
+    /// Go to the next string.
+    view_iterator& operator++()
+    {
+        ++position;
+        return *this;
+    }
+
+    /// Go to the next string, return the previous position.
+    view_iterator operator++(int)
+    {
+        auto const previous = *this;
+        ++position;
+        return previous;
+    }
+
+    /// Check whether both refer to the same string.
+    friend bool operator==(view_iterator const& lhs, view_iterator const& rhs)
+    {
+        return lhs.position == rhs.position;
+    }
+
+    /// Check whether both refer to different strings.
+    friend bool operator!=(view_iterator const& lhs, view_iterator const& rhs)
+    {
+        return not (lhs == rhs);
+    }
+
+  private:
+    /// The adapted iterator.
+    Iterator position{};
+};
+
+/// Available if `T` has no member function `get_allocator()`
+template <typename T,
+          typename = std::void_t<>>
+struct has_get_allocator : std::false_type
+{
+};
+
+/// Available if `T` has a member function `get_allocator()`
+template <typename T>
+struct has_get_allocator<T, std::void_t<
+    decltype(std::declval<T const&>().get_allocator())
+    >> : std::true_type
+{
+};
+
+/// An empty `String` using the allocator of `storage` (if it has one).
+template <typename String, typename Storage>
+String make_fragment([[maybe_unused]] Storage const& storage)
+{
+    if constexpr (has_get_allocator<Storage>::value)
+    {
+        return String{typename String::allocator_type{storage.get_allocator()}};
+    }
+    else
+    {
+        return String{};
+    }
+}
+
+}
+
+/// \brief Interface between `basic_string_builder` and its storage.
+///
+/// This primary template handles containers of strings, e.g. `std::deque<std::string>`.
+/// Every fragment is stored as a separate string.
+///
+/// Other storages (see `chunked_storage`) can be used by specializing `storage_traits`.
+///
+/// \tparam Storage The type of the storage.
+template <typename Storage>
+struct storage_traits
+{
+    /// Type used for sizes.
+    using size_type = std::string::size_type;
+
+    /// Store a new fragment written by `writer` and return its size.
+    template <typename Writer>
+    static size_type append(Storage& storage, Writer&& writer, size_type const size_hint = 0)
+    {
+        using string_type = typename detail::stored_string<Storage>::type;
+        auto fragment = detail::make_fragment<string_type>(storage);
+        fragment.reserve(size_hint);
+        basic_string_sink<string_type> out{fragment};
+        writer(static_cast<sink&>(out));
+        storage.emplace_back(std::move(fragment));
+        return storage.back().size();
+    }
+
+    /// Store a copy of `view` as new fragment and return its size.
+    static size_type append_view(Storage& storage, std::string_view const view)
+    {
+        return append(storage, [view](sink& out)
+        {
+            out.append(view);
+        }, view.size());
+    }
+
+    /// Store a new fragment written by `writer` in front (requires `emplace_front`) and return its size.
+    template <typename Writer>
+    static size_type prepend(Storage& storage, Writer&& writer, size_type const size_hint = 0)
+    {
+        using string_type = typename detail::stored_string<Storage>::type;
+        auto fragment = detail::make_fragment<string_type>(storage);
+        fragment.reserve(size_hint);
+        basic_string_sink<string_type> out{fragment};
+        writer(static_cast<sink&>(out));
+        storage.emplace_front(std::move(fragment));
+        return storage.front().size();
+    }
+
+    /// Store a copy of `view` as new fragment in front and return its size.
+    static size_type prepend_view(Storage& storage, std::string_view const view)
+    {
+        return prepend(storage, [view](sink& out)
+        {
+            out.append(view);
+        }, view.size());
+    }
+
+    /// \brief Store a new fragment of `size` characters `fill` and return its characters.
+    ///
+    /// The characters stay valid as long as the container keeps references to its elements valid
+    /// (e.g. `std::deque` and `std::list` do).
+    static char* append_slot(Storage& storage, size_type const size, char const fill)
+    {
+        using string_type = typename detail::stored_string<Storage>::type;
+        auto fragment = detail::make_fragment<string_type>(storage);
+        fragment.assign(size, fill);
+        storage.emplace_back(std::move(fragment));
+        return storage.back().data();
+    }
+
+    /// \brief Move the strings of `other` behind the strings of `storage`; `other` is empty afterwards.
+    ///
+    /// The strings are moved, i.e. their characters are not copied (except for short strings).
+    /// If an exception is thrown, the strings are moved back (strong guarantee).
+    static void splice(Storage& storage, Storage& other, bool)
+    {
+        std::size_t moved{0};
+        try
+        {
+            for (auto& fragment : other)
+            {
+                storage.emplace_back(std::move(fragment));
+                ++moved;
+            }
+        }
+        catch (...)
+        {
+            auto const first = std::prev(std::end(storage), static_cast<std::ptrdiff_t>(moved));
+            std::move(first, std::end(storage), std::begin(other));
+            for (; moved != 0; --moved)
+            {
+                storage.pop_back();
+            }
+            throw;
+        }
+        other.clear();
+    }
+
+    /// Remove the fragment that was added last.
+    static void pop_back(Storage& storage)
+    {
+        storage.pop_back();
+    }
+
+    /// Remove the fragment that was prepended last.
+    static void pop_front(Storage& storage)
+    {
+        storage.pop_front();
+    }
+
+    /// The maximal size of a string built from this storage.
+    static auto max_size(Storage& storage)
+    {
+        return storage.back().max_size();
+    }
+
+    /// Check whether no fragments are stored.
+    static bool empty(Storage const& storage)
+    {
+        return storage.empty();
+    }
+
+    /// Number of stored fragments.
+    static std::size_t size(Storage const& storage)
+    {
+        return storage.size();
+    }
+
+    /// Remove all fragments.
+    static void clear(Storage& storage)
+    {
+        storage.clear();
+    }
+
+    /// \brief Remove all fragments, keeping what `clear()` of the container keeps.
+    ///
+    /// E.g. `std::vector` keeps its capacity, the fragments themselves are released.
+    static void reset(Storage& storage, size_type)
+    {
+        storage.clear();
+    }
+
+    /// Number of allocated memory blocks; every fragment is a separate string.
+    static std::size_t allocations(Storage const& storage)
+    {
+        return storage.size();
+    }
+
+    /// Move the fragment to `target` if it is the only one; return whether it was moved.
+    template <typename Target>
+    static bool take_single(Storage& storage, Target& target)
+    {
+        if (storage.size() != 1)
+        {
+            return false;
+        }
+        target = std::move(storage.front());
+        return true;
+    }
+
+    /// Forward iterator to the first fragment, yields `std::string_view`.
+    static auto segments_begin(Storage const& storage)
+    {
+        return detail::view_iterator{std::cbegin(storage)};
+    }
+
+    /// Iterator behind the last fragment.
+    static auto segments_end(Storage const& storage)
+    {
+        return detail::view_iterator{std::cend(storage)};
+    }
+
+    /// Call `function` with a `std::string_view` of each stored fragment, starting at index `first_fragment`.
+    template <typename Function>
+    static void for_each_segment(Storage const& storage, Function&& function, std::size_t const first_fragment = 0)
+    {
+        auto first = std::next(std::cbegin(storage), static_cast<std::ptrdiff_t>(first_fragment));
+        std::for_each(first, std::cend(storage), [&function](auto const& fragment)
+        {
+            function(std::string_view{fragment});
+        });
+    }
+};
+
+/// `storage_traits` for `chunked_storage`.
+template <typename String>
+struct storage_traits<chunked_storage<String>>
+{
+    /// The storage.
+    using storage_type = chunked_storage<String>;
+    /// Type used for sizes.
+    using size_type = typename storage_type::size_type;
+
+    /// Store a new fragment written by `writer` and return its size.
+    template <typename Writer>
+    static size_type append(storage_type& storage, Writer&& writer, size_type const size_hint = 0)
+    {
+        return storage.append(std::forward<Writer>(writer), size_hint);
+    }
+
+    /// Store `view` without copying its characters and return its size.
+    static size_type append_view(storage_type& storage, std::string_view const view)
+    {
+        return storage.append_view(view);
+    }
+
+    /// Store a new fragment written by `writer` in front and return its size.
+    template <typename Writer>
+    static size_type prepend(storage_type& storage, Writer&& writer, size_type const size_hint = 0)
+    {
+        return storage.prepend(std::forward<Writer>(writer), size_hint);
+    }
+
+    /// Store `view` in front without copying its characters and return its size.
+    static size_type prepend_view(storage_type& storage, std::string_view const view)
+    {
+        return storage.prepend_view(view);
+    }
+
+    /// Store a new fragment of `size` characters `fill` and return its characters.
+    static char* append_slot(storage_type& storage, size_type const size, char const fill)
+    {
+        return storage.append_slot(size, fill);
+    }
+
+    /// Move the fragments and chunks of `other` behind the fragments of `storage` (see `chunked_storage::splice()`).
+    static void splice(storage_type& storage, storage_type& other, bool const may_copy)
+    {
+        storage.splice(other, may_copy);
+    }
+
+    /// Remove the fragment that was added last.
+    static void pop_back(storage_type& storage)
+    {
+        storage.pop_back();
+    }
+
+    /// Remove the fragment that was prepended last.
+    static void pop_front(storage_type& storage)
+    {
+        storage.pop_front();
+    }
+
+    /// The maximal size of a string built from this storage.
+    static size_type max_size(storage_type const& storage)
+    {
+        return storage.max_size();
+    }
+
+    /// Check whether no fragments are stored.
+    static bool empty(storage_type const& storage)
+    {
+        return storage.empty();
+    }
+
+    /// Number of stored fragments.
+    static std::size_t size(storage_type const& storage)
+    {
+        return storage.size();
+    }
+
+    /// Remove all fragments.
+    static void clear(storage_type& storage)
+    {
+        storage.clear();
+    }
+
+    /// Remove all fragments, but keep chunks of up to `retained_capacity` bytes.
+    static void reset(storage_type& storage, size_type const retained_capacity)
+    {
+        storage.reset(retained_capacity);
+    }
+
+    /// Number of allocated memory blocks, i.e. chunks.
+    static std::size_t allocations(storage_type const& storage)
+    {
+        return storage.chunk_count();
+    }
+
+    /// Fragments live in chunks and cannot be moved to a string.
+    template <typename Target>
+    static bool take_single(storage_type&, Target&)
+    {
+        return false;
+    }
+
+    /// Forward iterator to the first segment of adjacent fragments, yields `std::string_view`.
+    static auto segments_begin(storage_type const& storage) noexcept
+    {
+        return storage.begin_fragments();
+    }
+
+    /// Iterator behind the last segment.
+    static auto segments_end(storage_type const& storage) noexcept
+    {
+        return storage.end_fragments();
+    }
+
+    /// Call `function` with consecutive `std::string_view` segments, starting at fragment `first_fragment`.
+    template <typename Function>
+    static void for_each_segment(storage_type const& storage, Function&& function, std::size_t const first_fragment = 0)
+    {
+        storage.for_each_segment(std::forward<Function>(function), first_fragment);
+    }
+};
+
+
+namespace detail
+{
+
+/// Result size below which copying with several threads does not pay off.
+inline constexpr std::size_t parallel_threshold{4 * 1024 * 1024};
+
+/// \brief Copy the concatenation of `segments` to `destination` using `thread_count` threads.
+///
+/// The output is split into `thread_count` byte ranges of (almost) equal size.
+/// The position of every segment in the output is computed with a prefix sum,
+/// so every thread can copy its range independently.
+///
+/// \param segments The strings to concatenate.
+/// \param destination Memory for the result, large enough for all segments.
+/// \param thread_count Number of threads to use (including the calling thread).
+///
+/// \throws std::system_error if a thread cannot be started
+inline void parallel_copy(std::vector<std::string_view> const& segments, char* const destination, unsigned const thread_count)
+{
+    std::vector<std::size_t> offsets(segments.size() + 1, 0);
+    std::transform_inclusive_scan(std::cbegin(segments), std::cend(segments), std::next(std::begin(offsets)),
+                                  std::plus<>{}, [](std::string_view const segment)
+    {
+        return segment.size();
+    });
+    auto const total = offsets.back();
+
+    auto const copy_range = [&segments, &offsets, destination](std::size_t const first, std::size_t const last)
+    {
+        // index of the segment containing byte `first`
+        auto index = static_cast<std::size_t>(std::distance(std::cbegin(offsets),
+            std::upper_bound(std::cbegin(offsets), std::cend(offsets), first))) - 1;
+        for (auto position = first; position < last; ++index)
+        {
+            auto const segment = segments[index];
+            auto const begin = position - offsets[index];
+            auto const count = std::min(segment.size() - begin, last - position);
+            std::copy_n(segment.data() + begin, count, destination + position);
+            position += count;
+        }
+    };
+
+    auto const range_begin = [total, thread_count](unsigned const thread)
+    {
+        return total / thread_count * thread + std::min<std::size_t>(thread, total % thread_count);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    try
+    {
+        for (unsigned thread{1}; thread < thread_count; ++thread)
+        {
+            threads.emplace_back(copy_range, range_begin(thread), range_begin(thread + 1));
+        }
+    }
+    catch (...)
+    {
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        throw;
+    }
+    copy_range(range_begin(0), range_begin(1));
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+}
+
+
+#ifdef BOSSWESTFALEN_SB_POSIX
+
+namespace detail
+{
+
+/// \brief Write all buffers described by `buffers` to the file descriptor `fd`.
+///
+/// `writev` is called with batches of at most `IOV_MAX` buffers.
+/// Partial writes are continued and calls interrupted by a signal (`EINTR`) are repeated.
+/// `buffers` is modified.
+///
+/// \return Number of bytes written.
+///
+/// \throws std::system_error if `writev` fails, including `EAGAIN` of a non-blocking `fd`
+///     (which is not retried), or if it writes nothing although bytes remain (`std::errc::io_error`)
+inline std::size_t write_all(int const fd, std::vector<iovec>& buffers)
+{
+    static auto const iov_max = std::max(::sysconf(_SC_IOV_MAX), 16L);
+
+    std::size_t written{0};
+    auto first = std::begin(buffers);
+    auto const last = std::end(buffers);
+    while (first != last)
+    {
+        auto const count = static_cast<int>(std::min<std::ptrdiff_t>(std::distance(first, last), iov_max));
+        auto result = ::writev(fd, &*first, count);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error{errno, std::generic_category(), "writev"};
+        }
+
+        written += static_cast<std::size_t>(result);
+        // skip buffers that were written completely, adjust a partially written one
+        auto const batch = first;
+        auto const progress = result != 0;
+        for (; first != last and static_cast<std::size_t>(result) >= first->iov_len; ++first)
+        {
+            result -= static_cast<ssize_t>(first->iov_len);
+        }
+        if (not progress and first == batch)
+        {
+            // nothing written and no empty buffer skipped, another call would not make progress
+            throw std::system_error{std::make_error_code(std::errc::io_error), "writev wrote nothing"};
+        }
+        if (first != last)
+        {
+            first->iov_base = static_cast<char*>(first->iov_base) + result;
+            first->iov_len -= static_cast<std::size_t>(result);
+        }
+    }
+    return written;
+}
+
+}
+
+
+/// How `basic_string_builder::build_to_mapping()` flushes the mapped file.
+enum class mapping_sync
+{
+    /// Only unmap; the system writes the pages back later.
+    none,
+    /// `msync(MS_ASYNC)`: start writing the pages back, do not wait.
+    async,
+    /// `msync(MS_SYNC)`: wait until the pages are written back.
+    sync
+};
+
+/// \brief Options of `basic_string_builder::build_to_mapping()`.
+///
+/// \note Only available on POSIX systems.
+struct mapping_options final
+{
+    /// How the mapped file is flushed before it is unmapped.
+    mapping_sync sync{mapping_sync::none};
+    /// Whether the pages are announced to be written in order (`madvise(MADV_SEQUENTIAL)`).
+    bool sequential{true};
+    /// Number of threads copying disjoint parts of the result (including the calling thread).
+    unsigned thread_count{1};
+    /// Minimal size of the result to use more than one thread (see `basic_string_builder::build_parallel()`).
+    std::size_t threshold{detail::parallel_threshold};
+};
+
+namespace detail
+{
+
+/// \brief Set the size of the file `fd` to `size` bytes and allocate its blocks if supported.
+///
+/// Allocating the blocks before the file is mapped turns a full disk into an exception
+/// instead of `SIGBUS` while writing to the mapping.
+///
+/// \throws std::system_error if the file cannot be resized or there is not enough space
+inline void resize_file(int const fd, std::size_t const size)
+{
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "ftruncate"};
+    }
+#if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO > 0
+    if (size != 0)
+    {
+        auto const error = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+        // some file systems cannot allocate in advance
+        if (error != 0 and error != EINVAL and error != EOPNOTSUPP)
+        {
+            throw std::system_error{error, std::generic_category(), "posix_fallocate"};
+        }
+    }
+#endif
+}
+
+/// Shared, writable mapping of the beginning of a file; unmapped on destruction.
+class file_mapping final
+{
+  public:
+    /// \brief Map the first `size` (> 0) bytes of the file `fd`.
+    ///
+    /// \throws std::system_error if `mmap` fails (e.g. `fd` is not open for reading and writing)
+    file_mapping(int const fd, std::size_t const size)
+        : length{size}
+    {
+        auto const address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            throw std::system_error{errno, std::generic_category(), "mmap"};
+        }
+        memory = static_cast<char*>(address);
+    }
+
+    /// Not copyable.
+    file_mapping(file_mapping const&) = delete;
+    /// Not copyable.
+    file_mapping& operator=(file_mapping const&) = delete;
+
+    /// Unmap the file.
+    ~file_mapping()
+    {
+        ::munmap(memory, length);
+    }
+
+    /// The mapped bytes.
+    char* data() const noexcept
+    {
+        return memory;
+    }
+
+    /// Announce that the pages are written in order. This is only a hint, so errors are ignored.
+    void advise_sequential() const noexcept
+    {
+        ::madvise(memory, length, MADV_SEQUENTIAL);
+    }
+
+    /// \brief Flush the mapped pages according to `policy`.
+    ///
+    /// \throws std::system_error if `msync` fails
+    void sync(mapping_sync const policy) const
+    {
+        if (policy == mapping_sync::none)
+        {
+            return;
+        }
+        if (::msync(memory, length, policy == mapping_sync::sync ? MS_SYNC : MS_ASYNC) != 0)
+        {
+            throw std::system_error{errno, std::generic_category(), "msync"};
+        }
+    }
+
+  private:
+    /// Start of the mapping.
+    char* memory{nullptr};
+    /// Number of mapped bytes.
+    std::size_t length;
+};
+
+/// File descriptor that is closed on destruction.
+class file_descriptor final
+{
+  public:
+    /// \brief Open `path` with `flags` (and permissions 0666 if it is created).
+    ///
+    /// \throws std::system_error if `open` fails
+    file_descriptor(std::string const& path, int const flags)
+        : fd{::open(path.c_str(), flags, 0666)}
+    {
+        if (fd < 0)
+        {
+            throw std::system_error{errno, std::generic_category(), "open " + path};
+        }
+    }
+
+    /// Not copyable.
+    file_descriptor(file_descriptor const&) = delete;
+    /// Not copyable.
+    file_descriptor& operator=(file_descriptor const&) = delete;
+
+    /// Close the file descriptor.
+    ~file_descriptor()
+    {
+        ::close(fd);
+    }
+
+    /// The file descriptor.
+    int get() const noexcept
+    {
+        return fd;
+    }
+
+  private:
+    /// The file descriptor.
+    int fd;
+};
+
+}
+
+#endif // BOSSWESTFALEN_SB_POSIX
+
+
+/// \brief Paths `basic_string_builder::add()` takes to store a value (see `append_to`).
+enum class conversion_path
+{
+    /// `add_view()` or an array of `char const`, no conversion
+    view,
+    /// built-in `sb_append` hook for arithmetic types
+    arithmetic,
+    /// built-in `sb_append` hook for types convertible to `std::string`
+    string_conversion,
+    /// user-provided `sb_append` hook
+    custom_hook,
+    /// `to_string(value)`
+    external_to_string,
+    /// `operator<<(std::ostream&, value)`, the slowest path
+    stream_operator
+};
+
+/// Number of enumerators of `conversion_path`.
+inline constexpr std::size_t conversion_path_count{6};
+
+/// Name of `path` as used in reports.
+constexpr std::string_view conversion_path_name(conversion_path const path) noexcept
+{
+    constexpr std::array<std::string_view, conversion_path_count> names{
+        "view", "arithmetic", "string_conversion", "custom_hook", "external_to_string", "stream_operator"};
+    return names[static_cast<std::size_t>(path)];
+}
+
+namespace detail
+{
+
+/// Path `basic_string_builder::add()` takes for a value of type `T`.
+template <typename T>
+constexpr conversion_path conversion_path_of() noexcept
+{
+    if constexpr (type_traits::is_const_char_array<T>::value)
+    {
+        return conversion_path::view;
+    }
+    else if constexpr (type_traits::has_sb_append_v<T>)
+    {
+        if constexpr (type_traits::is_builtin_type_v<T>)
+        {
+            return conversion_path::arithmetic;
+        }
+        else if constexpr (type_traits::is_automatically_convertible_v<T>)
+        {
+            return conversion_path::string_conversion;
+        }
+        else
+        {
+            return conversion_path::custom_hook;
+        }
+    }
+    else if constexpr (type_traits::has_external_to_string_v<T>)
+    {
+        return conversion_path::external_to_string;
+    }
+    else
+    {
+        return conversion_path::stream_operator;
+    }
+}
+
+}
+
+/// \brief Statistics collected by `collect_statistics`.
+///
+/// A plain copy of the counters, e.g. returned by `global_statistics()`.
+struct statistics_snapshot final
+{
+    /// Number of buckets of `fragment_sizes`.
+    static constexpr std::size_t histogram_size{32};
+
+    /// Number of values added per `conversion_path`.
+    std::array<std::uint64_t, conversion_path_count> conversions{};
+    /// Histogram of fragment sizes, see `bucket()`.
+    std::array<std::uint64_t, histogram_size> fragment_sizes{};
+    /// Number of stored fragments.
+    std::uint64_t fragments{0};
+    /// Sum of the sizes of all stored fragments.
+    std::uint64_t fragment_bytes{0};
+    /// Number of memory blocks allocated by the storages.
+    std::uint64_t allocations{0};
+    /// Number of concatenations (`build()` and friends).
+    std::uint64_t builds{0};
+    /// Number of bytes copied by concatenations.
+    std::uint64_t bytes_copied{0};
+    /// Time spent in concatenations.
+    std::uint64_t build_nanoseconds{0};
+
+    /// \brief Index of the bucket of `fragment_sizes` counting fragments of `size`.
+    ///
+    /// Bucket 0 counts empty fragments, bucket *i* counts sizes in [2^(i-1), 2^i).
+    /// The last bucket also counts all larger sizes.
+    static constexpr std::size_t bucket(std::size_t size) noexcept
+    {
+        std::size_t index{0};
+        for (; size != 0 and index + 1 < histogram_size; size >>= 1)
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    /// Add the counters of `other`.
+    statistics_snapshot& operator+=(statistics_snapshot const& other) noexcept
+    {
+        std::transform(std::cbegin(conversions), std::cend(conversions), std::cbegin(other.conversions),
+                       std::begin(conversions), std::plus<>{});
+        std::transform(std::cbegin(fragment_sizes), std::cend(fragment_sizes), std::cbegin(other.fragment_sizes),
+                       std::begin(fragment_sizes), std::plus<>{});
+        fragments += other.fragments;
+        fragment_bytes += other.fragment_bytes;
+        allocations += other.allocations;
+        builds += other.builds;
+        bytes_copied += other.bytes_copied;
+        build_nanoseconds += other.build_nanoseconds;
+        return *this;
+    }
+};
+
+/// \brief Write a human readable report of `statistics`, one counter group per line.
+///
+/// Empty histogram buckets are omitted.
+inline std::ostream& operator<<(std::ostream& stream, statistics_snapshot const& statistics)
+{
+    stream << "conversions:";
+    for (std::size_t path{0}; path < conversion_path_count; ++path)
+    {
+        stream << ' ' << conversion_path_name(static_cast<conversion_path>(path))
+               << '=' << statistics.conversions[path];
+    }
+    stream << "\nfragments: " << statistics.fragments << " (" << statistics.fragment_bytes << " bytes)"
+           << "\nfragment sizes:";
+    for (std::size_t bucket{0}; bucket < statistics_snapshot::histogram_size; ++bucket)
+    {
+        if (statistics.fragment_sizes[bucket] == 0)
+        {
+            continue;
+        }
+        if (bucket == 0)
+        {
+            stream << " 0";
+        }
+        else
+        {
+            stream << " [" << (std::uint64_t{1} << (bucket - 1)) << ',';
+            if (bucket + 1 < statistics_snapshot::histogram_size)
+            {
+                stream << (std::uint64_t{1} << bucket) << ')';
+            }
+            else
+            {
+                stream << "inf)";
+            }
+        }
+        stream << '=' << statistics.fragment_sizes[bucket];
+    }
+    return stream << "\nallocations: " << statistics.allocations
+                  << "\nbuilds: " << statistics.builds << " (" << statistics.bytes_copied << " bytes copied, "
+                  << statistics.build_nanoseconds << " ns)\n";
+}
+
+namespace detail
+{
+
+/// \brief Statistics of one thread.
+///
+/// Only the owning thread writes, other threads may read at any time.
+class statistics_record final
+{
+  public:
+    /// Count a value added via `path`.
+    void conversion(conversion_path const path) noexcept
+    {
+        increment(conversions[static_cast<std::size_t>(path)]);
+    }
+
+    /// Count a stored fragment of `size`.
+    void fragment(std::size_t const size) noexcept
+    {
+        increment(fragment_sizes[statistics_snapshot::bucket(size)]);
+        increment(fragments);
+        increment(fragment_bytes, size);
+    }
+
+    /// Count `count` allocations.
+    void allocations(std::size_t const count) noexcept
+    {
+        increment(allocation_count, count);
+    }
+
+    /// Count a concatenation.
+    void build(std::size_t const bytes, std::uint64_t const nanoseconds) noexcept
+    {
+        increment(builds);
+        increment(bytes_copied, bytes);
+        increment(build_nanoseconds, nanoseconds);
+    }
+
+    /// Copy the counters.
+    statistics_snapshot snapshot() const noexcept
+    {
+        statistics_snapshot result;
+        auto const load = [](counter const& value)
+        {
+            return value.load(std::memory_order_relaxed);
+        };
+        std::transform(std::cbegin(conversions), std::cend(conversions), std::begin(result.conversions), load);
+        std::transform(std::cbegin(fragment_sizes), std::cend(fragment_sizes), std::begin(result.fragment_sizes), load);
+        result.fragments = load(fragments);
+        result.fragment_bytes = load(fragment_bytes);
+        result.allocations = load(allocation_count);
+        result.builds = load(builds);
+        result.bytes_copied = load(bytes_copied);
+        result.build_nanoseconds = load(build_nanoseconds);
+        return result;
+    }
+
+    /// \brief Set all counters to 0.
+    ///
+    /// Increments of the owning thread running at the same time may be lost.
+    void reset() noexcept
+    {
+        for (auto& value : conversions)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (auto& value : fragment_sizes)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (auto* value : {&fragments, &fragment_bytes, &allocation_count, &builds, &bytes_copied, &build_nanoseconds})
+        {
+            value->store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    /// A counter readable by other threads.
+    using counter = std::atomic<std::uint64_t>;
+
+    std::array<counter, conversion_path_count> conversions{};
+    std::array<counter, statistics_snapshot::histogram_size> fragment_sizes{};
+    counter fragments{0};
+    counter fragment_bytes{0};
+    counter allocation_count{0};
+    counter builds{0};
+    counter bytes_copied{0};
+    counter build_nanoseconds{0};
+
+    /// Only the owning thread writes, so no read-modify-write operation is needed.
+    static void increment(counter& value, std::uint64_t const amount = 1) noexcept
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+/// \brief All `statistics_record`s of running threads and the sum of those of finished threads.
+class statistics_registry final
+{
+  public:
+    /// The process-wide registry.
+    static statistics_registry& instance()
+    {
+        static statistics_registry registry;
+        return registry;
+    }
+
+    /// Start collecting `record`.
+    void attach(statistics_record& record)
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        records.push_back(&record);
+    }
+
+    /// Stop collecting `record`; its counters are kept.
+    void detach(statistics_record& record) noexcept
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        retired += record.snapshot();
+        records.erase(std::remove(std::begin(records), std::end(records), &record), std::end(records));
+    }
+
+    /// Sum of all records.
+    statistics_snapshot collect() const
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        auto result = retired;
+        for (auto const* record : records)
+        {
+            result += record->snapshot();
+        }
+        return result;
+    }
+
+    /// Set all counters to 0.
+    void reset() noexcept
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        retired = statistics_snapshot{};
+        for (auto* record : records)
+        {
+            record->reset();
+        }
+    }
+
+  private:
+    mutable std::mutex mutex{};
+    std::vector<statistics_record*> records{};
+    statistics_snapshot retired{};
+};
+
+/// `statistics_record` of a thread that is registered while the thread runs.
+class registered_statistics final
+{
+  public:
+    registered_statistics()
+    {
+        statistics_registry::instance().attach(record);
+    }
+
+    registered_statistics(registered_statistics const&) = delete;
+    registered_statistics& operator=(registered_statistics const&) = delete;
+
+    ~registered_statistics()
+    {
+        statistics_registry::instance().detach(record);
+    }
+
+    /// The counters of the thread.
+    statistics_record record{};
+};
+
+/// The `statistics_record` of the calling thread.
+inline statistics_record& local_statistics()
+{
+    thread_local registered_statistics statistics;
+    return statistics.record;
+}
+
+}
+
+/// \brief Statistics policy of `basic_string_builder` that collects nothing.
+///
+/// All instrumentation is removed at compile time.
+struct no_statistics final
+{
+    /// Disables the instrumentation.
+    static constexpr bool enabled{false};
+};
+
+/// \brief Statistics policy of `basic_string_builder` that collects per thread.
+///
+/// Counters are kept per thread and can be read with `thread_statistics()` and `global_statistics()`.
+///
+/// A custom policy provides the same members, e.g. to collect the statistics of a single call site.
+struct collect_statistics final
+{
+    /// Enables the instrumentation.
+    static constexpr bool enabled{true};
+
+    /// A value was added via `path`.
+    static void on_conversion(conversion_path const path)
+    {
+        detail::local_statistics().conversion(path);
+    }
+
+    /// A fragment of `size` was stored.
+    static void on_fragment(std::size_t const size)
+    {
+        detail::local_statistics().fragment(size);
+    }
+
+    /// The storage allocated `count` memory blocks.
+    static void on_allocations(std::size_t const count)
+    {
+        detail::local_statistics().allocations(count);
+    }
+
+    /// A concatenation copied `bytes` and took `nanoseconds`.
+    static void on_build(std::size_t const bytes, std::uint64_t const nanoseconds)
+    {
+        detail::local_statistics().build(bytes, nanoseconds);
+    }
+};
+
+/// Statistics collected by `collect_statistics` in the calling thread.
+inline statistics_snapshot thread_statistics()
+{
+    return detail::local_statistics().snapshot();
+}
+
+/// \brief Statistics collected by `collect_statistics` in all threads.
+///
+/// Includes threads that finished already. Can be called at any time, e.g. for periodic dumps.
+inline statistics_snapshot global_statistics()
+{
+    return detail::statistics_registry::instance().collect();
+}
+
+/// Set the statistics of all threads to 0.
+inline void reset_statistics()
+{
+    detail::statistics_registry::instance().reset();
+}
+
+
+/// \brief Characters reserved inside a builder that are filled later.
+///
+/// Created by `basic_string_builder::reserve_slot()`, e.g. for a length header
+/// that is only known after the body was added:
+/// \code
+/// auto header = sb.reserve_slot(8, '0');
+/// sb.add(body);
+/// header.fill(width(sb.size() - 8, 8, '0'));
+/// \endcode
+///
+/// A `slot` refers to the storage of the builder. It is valid until the builder
+/// is cleared (by `take()` or `clear()`) or destroyed. Copies of the builder have their own characters.
+class slot final
+{
+  public:
+    /// Refer to `size` characters starting at `data`.
+    slot(char* const data, std::size_t const size) noexcept
+        : characters{data}
+        , count{size}
+    {
+    }
+
+    /// The reserved characters.
+    char* data() const noexcept
+    {
+        return characters;
+    }
+
+    /// Number of reserved characters.
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+    /// \brief Write `value` to the beginning of the slot (see `append_to`).
+    ///
+    /// Characters not written keep their previous value.
+    ///
+    /// \return The number of characters written.
+    ///
+    /// \throws std::length_error if `value` needs more than `size()` characters.
+    ///     The slot is unchanged in this case.
+    template <typename T>
+    std::size_t fill(T const& value) const
+    {
+        detail::inline_sink<64> out;
+        append_to(out, value);
+        auto const text = out.view();
+        if (text.size() > count)
+        {
+            throw std::length_error{"value does not fit into slot"};
+        }
+        std::copy(std::cbegin(text), std::cend(text), characters);
+        return text.size();
+    }
+
+  private:
+    /// The reserved characters.
+    char* characters;
+    /// Number of reserved characters.
+    std::size_t count;
+};
+
+/// \brief Memory kept by `basic_string_builder::clear()` for the next use of the builder.
+///
+/// Memory beyond the limits is released, so a single large result
+/// does not keep its memory for all later uses.
+struct shrink_policy final
+{
+    /// Maximal number of bytes kept in the storage (e.g. the chunks of `chunked_storage`).
+    std::size_t storage_capacity{1024 * 1024};
+    /// Maximal capacity kept of the result of `build_cached()`.
+    std::size_t cache_capacity{1024 * 1024};
+};
+
+/// \brief Read-only range of `std::string_view` segments whose concatenation is a result.
+///
+/// Returned by `basic_string_builder::segments()`.
+/// The segments are valid until the builder is changed or destroyed; segments may be empty.
+///
+/// \tparam Iterator Forward iterator yielding `std::string_view`.
+template <typename Iterator>
+class segment_range final
+{
+  public:
+    /// Iterator over the segments.
+    using iterator = Iterator;
+    /// Iterator over the segments.
+    using const_iterator = Iterator;
+
+    /// The segments from `first` to `last`.
+    segment_range(Iterator const first, Iterator const last)
+        : first{first}
+        , last{last}
+    {
+    }
+
+    /// Iterator to the first segment.
+    Iterator begin() const
+    {
+        return first;
+    }
+
+    /// Iterator behind the last segment.
+    Iterator end() const
+    {
+        return last;
+    }
+
+  private:
+    /// The first segment.
+    Iterator first;
+    /// Behind the last segment.
+    Iterator last;
+};
+
+/// \brief Incremental 64 bit FNV-1a hash.
+///
+/// The hash does not depend on how the characters are split into calls of `update()`,
+/// e.g. `basic_string_builder::hash()` equals `fnv1a(build())`.
+class fnv1a_hasher final
+{
+  public:
+    /// Continue the hash with the characters of `text`.
+    constexpr void update(std::string_view const text) noexcept
+    {
+        for (auto const character : text)
+        {
+            state = (state ^ static_cast<unsigned char>(character)) * prime;
+        }
+    }
+
+    /// The hash of all characters so far.
+    constexpr std::uint64_t value() const noexcept
+    {
+        return state;
+    }
+
+  private:
+    /// Initial state.
+    static constexpr std::uint64_t offset_basis{0xcbf29ce484222325};
+    /// Factor of every step.
+    static constexpr std::uint64_t prime{0x100000001b3};
+
+    /// The hash so far.
+    std::uint64_t state{offset_basis};
+};
+
+/// The 64 bit FNV-1a hash of `text` (see `fnv1a_hasher`).
+constexpr std::uint64_t fnv1a(std::string_view const text) noexcept
+{
+    fnv1a_hasher hasher;
+    hasher.update(text);
+    return hasher.value();
+}
+
+namespace detail
+{
+
+/// Compare the concatenations of the segments in [`first1`, `last1`) and [`first2`, `last2`) like `std::string_view::compare()`.
+template <typename Iterator1, typename Iterator2>
+int compare_segments(Iterator1 first1, Iterator1 const last1, Iterator2 first2, Iterator2 const last2)
+{
+    std::string_view lhs;
+    std::string_view rhs;
+    for (;;)
+    {
+        for (; lhs.empty() and first1 != last1; ++first1)
+        {
+            lhs = *first1;
+        }
+        for (; rhs.empty() and first2 != last2; ++first2)
+        {
+            rhs = *first2;
+        }
+        if (lhs.empty() or rhs.empty())
+        {
+            return lhs.empty() ? (rhs.empty() ? 0 : -1) : 1;
+        }
+        auto const count = std::min(lhs.size(), rhs.size());
+        if (auto const result = std::char_traits<char>::compare(lhs.data(), rhs.data(), count); result != 0)
+        {
+            return result;
+        }
+        lhs.remove_prefix(count);
+        rhs.remove_prefix(count);
+    }
+}
+
+/// Check whether the concatenation of the segments in [`first`, `last`) starts with `prefix`.
+template <typename Iterator>
+bool starts_with_segments(Iterator first, Iterator const last, std::string_view prefix)
+{
+    for (; not prefix.empty() and first != last; ++first)
+    {
+        auto const segment = *first;
+        auto const count = std::min(segment.size(), prefix.size());
+        if (std::char_traits<char>::compare(segment.data(), prefix.data(), count) != 0)
+        {
+            return false;
+        }
+        prefix.remove_prefix(count);
+    }
+    return prefix.empty();
+}
+
+/// \brief Find the first occurrence of `needle` at or after `start` in the concatenation of [`first`, `last`).
+///
+/// Occurrences inside a segment are found with `std::string_view::find()`,
+/// only the positions near the end of a segment are compared with the following segments.
+///
+/// \return The position of the occurrence or `std::string_view::npos`.
+///
+/// \pre `needle` is not empty.
+template <typename Iterator>
+std::size_t find_in_segments(Iterator first, Iterator const last, std::string_view const needle, std::size_t const start)
+{
+    assert(not needle.empty());
+    for (std::size_t base{0}; first != last; ++first)
+    {
+        auto const segment = *first;
+        auto const from = start > base ? start - base : 0;
+        if (from < segment.size())
+        {
+            if (auto const found = segment.find(needle, from); found != std::string_view::npos)
+            {
+                return base + found;
+            }
+            // occurrences that continue in the following segments
+            auto const tail = segment.size() >= needle.size() ? segment.size() - needle.size() + 1 : 0;
+            for (auto candidate = segment.find(needle.front(), std::max(from, tail));
+                 candidate != std::string_view::npos;
+                 candidate = segment.find(needle.front(), candidate + 1))
+            {
+                auto const head = segment.substr(candidate);
+                auto next = first;
+                if (needle.compare(0, head.size(), head) == 0
+                    and starts_with_segments(++next, last, needle.substr(head.size())))
+                {
+                    return base + candidate;
+                }
+            }
+        }
+        base += segment.size();
+    }
+    return std::string_view::npos;
+}
+
+}
+
+/// \brief The `basic_string_builder` allows to easily concatenate strings.
+///
+/// Strings are collected and concatenated on demand.
+/// Concatenating *a*, *b*, and *c* yields the string *abc*.
+///
+/// \tparam Cont The storage used for the added strings, instantiated as `Cont<string_type>`.
+///     Either `chunked_storage` or a container that supports
+///     * `emplace_back`
+///     * `back`, 
+///     * `pop_back`
+///     * `empty`
+///     * range-based `for`
+///     Other storages can be used by specializing `storage_traits`.
+/// \tparam Stats The statistics policy, `no_statistics` or `collect_statistics`.
+///     With `no_statistics` the builder contains no instrumentation.
+/// \tparam Allocator The allocator of the stored strings and the results, see `string_type`.
+///     It is passed to the storage, e.g. use `std::pmr::deque` with `std::pmr::polymorphic_allocator`
+///     (see `pmr::basic_string_builder`).
+///
+/// \note `basic_string_builder` is not thread-safe.
+template <template <typename> typename Cont, typename Stats = no_statistics, typename Allocator = std::allocator<char>>
+class basic_string_builder final
+{
+  public:
+    /// The allocator of the storage and the results.
+    using allocator_type = Allocator;
+    /// The type of stored strings and results, `std::string` for the default allocator.
+    using string_type = std::basic_string<char, std::char_traits<char>, Allocator>;
+
+    /// Default Ctor is sufficient.
+    basic_string_builder() = default;
+
+    /// \brief Use `allocator` for the storage and the results.
+    ///
+    /// No memory is allocated by the constructor.
+    explicit basic_string_builder(allocator_type const& allocator)
+        : storage{allocator}
+        , cache{allocator}
+    {
+    }
+
+    /// Copy the content; a `chunked_storage` is copied into a single chunk.
+    basic_string_builder(basic_string_builder const&) = default;
+
+    /// \brief Take over the storage of `other` without copying characters.
+    ///
+    /// `other` is empty afterwards, like after `take()`.
+    basic_string_builder(basic_string_builder&& other)
+        noexcept(std::is_nothrow_move_constructible_v<storage_type>)
+        : result_size{std::exchange(other.result_size, 0)}
+        , storage{std::move(other.storage)}
+        , cache{std::move(other.cache)}
+        , cached_fragments{std::exchange(other.cached_fragments, 0)}
+        , first_slot{std::exchange(other.first_slot, no_slot)}
+    {
+        traits::clear(other.storage);
+        other.cache.clear();
+    }
+
+    /// Copy the content of `other`.
+    basic_string_builder& operator=(basic_string_builder const&) = default;
+
+    /// \brief Take over the storage of `other` (see the move constructor).
+    ///
+    /// The storage is copied if the allocators differ and do not propagate.
+    /// `other` is empty afterwards.
+    basic_string_builder& operator=(basic_string_builder&& other)
+        noexcept(std::is_nothrow_move_assignable_v<storage_type> and std::is_nothrow_move_assignable_v<string_type>)
+    {
+        if (this != &other)
+        {
+            storage = std::move(other.storage);
+            result_size = std::exchange(other.result_size, 0);
+            first_slot = std::exchange(other.first_slot, no_slot);
+            // the cache is invalid until it is replaced, in case that throws
+            cached_fragments = 0;
+            cache = std::move(other.cache);
+            cached_fragments = std::exchange(other.cached_fragments, 0);
+            traits::clear(other.storage);
+            other.cache.clear();
+        }
+        return *this;
+    }
+
+    /// Nothing special to do on destruction.
+    ~basic_string_builder() = default;
+
+    /// \brief Add new content to the `basic_string_builder`.
+    ///
+    /// If required *input* will be converted to a std::string (see `append_to`).
+    /// It then is stored internally and will be used in `build()`.
+    ///
+    /// \tparam T The type of the input value.
+    /// \param value The value that will be converted to `std::string`
+    ///     and added to the internal storage.
+    ///
+    /// \attention Arrays of `char const` (e.g. string literals) are stored like `add_view()`,
+    ///     i.e. only a reference is stored. The array must outlive all uses of the builder.
+    ///     This is always true for string literals, but not for local arrays
+    ///     like `char const name[] = "..."`; use `add(std::string_view{name})` to copy those.
+    ///     All `N` characters of a `char const[N]` are used, except a terminating null character.
+    ///     Builders of the same type are added like `add(basic_string_builder const&)`.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during creation and storing
+    ///     (e.g. exceptions when creating the `std::string` or adding it
+    ///     to the container, with `emplace_back`)
+    template <typename T>
+    void add(T&& value)
+    {
+        if constexpr (type_traits::is_const_char_array<T>::value)
+        {
+            add_view(detail::array_view(value));
+        }
+        else if constexpr (std::is_same_v<std::decay_t<T>, basic_string_builder>)
+        {
+            // builders that are no rvalues and not const
+            add(static_cast<basic_string_builder const&>(value));
+        }
+        else
+        {
+            count_conversion<T>();
+            auto const size_hint = detail::size_hint(value);
+            store([&value](sink& out)
+            {
+                append_to(out, std::forward<T>(value));
+            }, size_hint);
+        }
+    }
+
+    /// \brief Add the concatenation of several values as a single string.
+    ///
+    /// Same as `add(concat(first, second, rest...))`, but the result of `concat`
+    /// is written directly into the storage.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during creation and storing
+    template <typename T, typename U, typename... Ts>
+    void add(T const& first, U const& second, Ts const&... rest)
+    {
+        count_conversion<T>();
+        count_conversion<U>();
+        (count_conversion<Ts>(), ...);
+        add_prepared(detail::prepared_argument<T>{first},
+                     detail::prepared_argument<U>{second},
+                     detail::prepared_argument<Ts>{rest}...);
+    }
+
+    /// \brief Add the elements of `range` with separators as a single string.
+    ///
+    /// Same as `add(join(range, separator, prefix, suffix))` (see `join`).
+    /// The elements are written in one pass; for string-like elements
+    /// the exact size is computed before, so nothing is moved.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during conversion and storing
+    template <typename Range>
+    void add_range(Range const& range, std::string_view const separator,
+                   std::string_view const prefix = {}, std::string_view const suffix = {})
+    {
+        auto const joined = join(range, separator, prefix, suffix);
+        count_conversion<decltype(joined)>();
+        store([&joined](sink& out)
+        {
+            sb_append(out, joined);
+        }, detail::joined_size(joined));
+    }
+
+    /// \brief Add characters without copying them.
+    ///
+    /// Only pointer and length of `view` are stored,
+    /// its characters are copied once in `build()`.
+    /// Storages that cannot hold references (e.g. `std::deque`) copy the characters.
+    ///
+    /// \param view The characters to add.
+    ///     They must stay valid and unchanged as long as the builder (or a copy of it) is used.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during storing
+    void add_view(std::string_view const view)
+    {
+        store_view<false>(view);
+    }
+
+    /// \brief Add the content of `other`, which is empty afterwards, without copying its characters.
+    ///
+    /// The stored strings of `other` (for `chunked_storage` its chunks) are moved into this builder,
+    /// so content built in nested builders is copied only once, by the final `build()`.
+    /// Slots of `other` (see `reserve_slot()`) stay valid for `chunked_storage`.
+    /// Small content of `other` without slots may be copied into free space of `chunked_storage` instead,
+    /// which is cheaper than keeping the mostly empty chunks of `other`.
+    /// Statistics count the content of `other` as one fragment added via `conversion_path::view`.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during storing
+    ///     Both builders are unchanged if an exception is thrown.
+    void add(basic_string_builder&& other)
+    {
+        if (&other == this)
+        {
+            add(build());
+            return;
+        }
+        if (result_size > cache.max_size() - other.result_size)
+        {
+            throw std::length_error{""};
+        }
+        auto const other_slot = other.first_slot == no_slot ? no_slot : traits::size(storage) + other.first_slot;
+        if constexpr (Stats::enabled)
+        {
+            // blocks taken over from `other` were counted when `other` allocated them
+            auto const allocations = traits::allocations(storage);
+            auto const other_allocations = traits::allocations(other.storage);
+            traits::splice(storage, other.storage, other.first_slot == no_slot);
+            auto const taken = other_allocations - traits::allocations(other.storage);
+            Stats::on_conversion(conversion_path::view);
+            Stats::on_allocations(traits::allocations(storage) - allocations - taken);
+            Stats::on_fragment(other.result_size);
+        }
+        else
+        {
+            traits::splice(storage, other.storage, other.first_slot == no_slot);
+        }
+        result_size += other.result_size;
+        first_slot = std::min(first_slot, other_slot);
+        other.clear();
+    }
+
+    /// \brief Add a copy of the content of `other` as a single string.
+    ///
+    /// The stored strings of `other` are copied directly into the storage,
+    /// i.e. without building the result of `other` first.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during storing
+    void add(basic_string_builder const& other)
+    {
+        store([&other](sink& out)
+        {
+            other.for_each_segment([&out](std::string_view const segment)
+            {
+                out.append(segment);
+            });
+        }, other.result_size);
+    }
+
+    /// \brief Add the content of `other` without copying it (see `add_view(std::string_view)`).
+    ///
+    /// Only references to the stored strings of `other` are stored, so `other` is shared cheaply.
+    /// Storages that cannot hold references (e.g. `std::deque`) copy the characters.
+    ///
+    /// \param other The builder to refer to.
+    ///     It must stay valid and unchanged as long as this builder (or a copy of it) is used.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during storing
+    ///     The references added so far are kept in this case.
+    void add_view(basic_string_builder const& other)
+    {
+        if (&other == this)
+        {
+            add(build());
+            return;
+        }
+        if (result_size > cache.max_size() - other.result_size)
+        {
+            throw std::length_error{""};
+        }
+        other.for_each_segment([this](std::string_view const segment)
+        {
+            store_view<false>(segment);
+        });
+    }
+
+    /// \brief Add new content in front of all content added so far.
+    ///
+    /// Same as `add()`, but the value becomes the beginning of the result, e.g. for a header
+    /// that is known only after the body was added. Nothing is moved or copied.
+    ///
+    /// \note Requires `emplace_front` for containers other than `chunked_storage`.
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during creation and storing
+    template <typename T>
+    void prepend(T&& value)
+    {
+        if constexpr (type_traits::is_const_char_array<T>::value)
+        {
+            prepend_view(detail::array_view(value));
+        }
+        else
+        {
+            count_conversion<T>();
+            auto const size_hint = detail::size_hint(value);
+            store<true>([&value](sink& out)
+            {
+                append_to(out, std::forward<T>(value));
+            }, size_hint);
+        }
+    }
+
+    /// \brief Add characters in front of all content added so far without copying them.
+    ///
+    /// See `add_view()` and `prepend()`.
+    void prepend_view(std::string_view const view)
+    {
+        store_view<true>(view);
+    }
+
+    /// \brief Add `size` characters `fill` that can be changed later through the returned `slot`.
+    ///
+    /// The size of the result includes the slot, so it can be filled with e.g. the length of
+    /// content added afterwards. `build()` uses the characters of the slot at the time of the call.
+    ///
+    /// \note Containers other than `chunked_storage` must keep references to their elements valid
+    ///     when elements are added (e.g. `std::deque`).
+    ///
+    /// \throws std::length_error if the size of the result of `build()`
+    ///     would be larger than the `std::string::max_size()`
+    /// \throws any exception that occurs during storing
+    slot reserve_slot(std::string::size_type const size, char const fill = ' ')
+    {
+        auto const index = traits::size(storage);
+        auto const data = traits::append_slot(storage, size, fill);
+        commit(size);
+        first_slot = std::min(first_slot, index);
+        if constexpr (Stats::enabled)
+        {
+            Stats::on_fragment(size);
+        }
+        return slot{data, size};
+    }
+
+    /// \brief Concatenate stored strings.
+    ///
+    /// All strings added so far will be concatenated without any delimiter.
+    /// Stored strings *a*, *b*, and *c* will result in *abc*.
+    /// 
+    /// \note The result is not stored.
+    /// Additional calls to `build()` will result in re-building, even if nothing changed.
+    /// See `build_cached()` and `build_into()` for alternatives.
+    ///
+    /// \return The concatenation of all stored strings.
+    string_type build() const&
+    {
+        if (traits::empty(storage))
+        {
+            return string_type{get_allocator()};
+        }
+
+        return concatenate();
+    }
+
+    /// \brief Concatenate stored strings of a builder that is not used anymore.
+    ///
+    /// Same as `take()`.
+    string_type build() &&
+    {
+        return take();
+    }
+
+    /// \brief Concatenate stored strings into `target`.
+    ///
+    /// The previous content of `target` is replaced, its capacity is reused.
+    ///
+    /// \param target The string receiving the result.
+    void build_into(string_type& target) const
+    {
+        target.clear();
+        target.reserve(result_size);
+        append_segments(target);
+    }
+
+    /// \brief Move the result out of the builder, which is empty afterwards.
+    ///
+    /// A single stored string or an up-to-date result of `build_cached()` is moved,
+    /// otherwise the stored strings are concatenated.
+    ///
+    /// \return The concatenation of all stored strings.
+    string_type take()
+    {
+        string_type result{get_allocator()};
+        if (cache_is_current())
+        {
+            result = std::move(cache);
+        }
+        else if (not traits::take_single(storage, result))
+        {
+            build_into(result);
+        }
+        traits::clear(storage);
+        result_size = 0;
+        cache.clear();
+        cached_fragments = 0;
+        first_slot = no_slot;
+        return result;
+    }
+
+    /// \brief Remove all stored strings, but keep memory for the next use.
+    ///
+    /// In contrast to `take()` the builder keeps its memory up to the limits of `policy`,
+    /// e.g. the chunks of `chunked_storage` and the capacity of the result of `build_cached()`.
+    /// Adding strings of similar sizes again does not allocate,
+    /// except for containers of strings, which store every string separately.
+    /// All slots (see `reserve_slot()`) become invalid.
+    ///
+    /// \param policy The memory kept at most.
+    void clear(shrink_policy const& policy = {}) noexcept
+    {
+        traits::reset(storage, policy.storage_capacity);
+        result_size = 0;
+        cache.clear();
+        if (cache.capacity() > policy.cache_capacity)
+        {
+            string_type{get_allocator()}.swap(cache);
+        }
+        cached_fragments = 0;
+        first_slot = no_slot;
+    }
+
+    /// \brief Concatenate stored strings and keep the result.
+    ///
+    /// The result is kept inside the builder.
+    /// A later call only appends the strings added in the meantime.
+    ///
+    /// \return The concatenation of all stored strings.
+    ///     The reference is valid until the builder is changed or destroyed.
+    string_type const& build_cached()
+    {
+        if (cached_fragments > first_slot)
+        {
+            // a slot in the cached part may have changed
+            cache.clear();
+            cached_fragments = 0;
+        }
+        if (cached_fragments == 0)
+        {
+            cache.reserve(result_size);
+        }
+        append_segments(cache, cached_fragments);
+        cached_fragments = traits::size(storage);
+        return cache;
+    }
+
+    /// Size of the result of `build()`.
+    std::string::size_type size() const noexcept
+    {
+        return result_size;
+    }
+
+    /// The allocator of the storage and the results.
+    allocator_type get_allocator() const noexcept
+    {
+        return cache.get_allocator();
+    }
+
+    /// \brief Call `function` with `std::string_view` segments whose concatenation is the result.
+    ///
+    /// Adjacent stored strings may be merged into one segment; empty segments may be skipped.
+    /// The segments are valid until the builder is changed or destroyed.
+    template <typename Function>
+    void for_each_segment(Function&& function) const
+    {
+        traits::for_each_segment(storage, std::forward<Function>(function));
+    }
+
+    /// \brief The stored strings as a range of `std::string_view` segments.
+    ///
+    /// The concatenation of the segments is the result of `build()`; segments may be empty.
+    /// The segments are valid until the builder is changed or destroyed.
+    auto segments() const
+    {
+        return segment_range<decltype(traits::segments_begin(storage))>{traits::segments_begin(storage),
+                                                                        traits::segments_end(storage)};
+    }
+
+    /// \brief Hash of the result of `build()` without building it.
+    ///
+    /// \param hasher Incremental hash with `update(std::string_view)` and `value()`,
+    ///     that does not depend on how the characters are split (e.g. `fnv1a_hasher`).
+    ///
+    /// \return `hasher.value()` after updating it with all segments,
+    ///     e.g. `fnv1a(build())` for the default.
+    template <typename Hasher = fnv1a_hasher>
+    auto hash(Hasher hasher = {}) const
+    {
+        for (auto const segment : segments())
+        {
+            hasher.update(segment);
+        }
+        return hasher.value();
+    }
+
+    /// Check whether the result of `build()` equals `text`, without building it.
+    bool equals(std::string_view const text) const
+    {
+        return result_size == text.size() and starts_with(text);
+    }
+
+    /// Check whether the results of `build()` of both builders are equal, without building them.
+    template <template <typename> typename OtherCont, typename OtherStats, typename OtherAllocator>
+    bool equals(basic_string_builder<OtherCont, OtherStats, OtherAllocator> const& other) const
+    {
+        return result_size == other.size() and compare(other) == 0;
+    }
+
+    /// Check whether the result of `build()` starts with `prefix`, without building it.
+    bool starts_with(std::string_view const prefix) const
+    {
+        auto const all = segments();
+        return prefix.size() <= result_size and detail::starts_with_segments(all.begin(), all.end(), prefix);
+    }
+
+    /// \brief Find `needle` in the result of `build()` like `std::string::find()`, without building it.
+    ///
+    /// Occurrences may span several stored strings.
+    ///
+    /// \param needle The characters to find.
+    /// \param position Position in the result to start at.
+    ///
+    /// \return The position of the first occurrence at or after `position`, or `std::string::npos`.
+    std::string::size_type find(std::string_view const needle, std::string::size_type const position = 0) const
+    {
+        if (needle.empty())
+        {
+            return position <= result_size ? position : std::string::npos;
+        }
+        if (position >= result_size or needle.size() > result_size - position)
+        {
+            return std::string::npos;
+        }
+        auto const all = segments();
+        return detail::find_in_segments(all.begin(), all.end(), needle, position);
+    }
+
+    /// Compare the result of `build()` with `text` like `std::string::compare()`, without building it.
+    int compare(std::string_view const text) const
+    {
+        auto const all = segments();
+        return detail::compare_segments(all.begin(), all.end(), &text, &text + 1);
+    }
+
+    /// Compare the results of `build()` of both builders like `std::string::compare()`, without building them.
+    template <template <typename> typename OtherCont, typename OtherStats, typename OtherAllocator>
+    int compare(basic_string_builder<OtherCont, OtherStats, OtherAllocator> const& other) const
+    {
+        auto const lhs = segments();
+        auto const rhs = other.segments();
+        return detail::compare_segments(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    /// Result size below which `build_parallel()` does not use additional threads.
+    static constexpr std::string::size_type default_parallel_threshold{detail::parallel_threshold};
+
+    /// \brief Concatenate stored strings using several threads.
+    ///
+    /// The position of every stored string in the result is computed first,
+    /// then the result is allocated once and the threads copy disjoint parts of it.
+    /// This pays off for very large results only; for results smaller than `threshold`
+    /// or a single thread `build()` is used.
+    ///
+    /// \param thread_count Number of threads to use (including the calling thread).
+    ///     Defaults to `std::thread::hardware_concurrency()`.
+    /// \param threshold Minimal size of the result to use more than one thread.
+    ///
+    /// \return The concatenation of all stored strings.
+    ///
+    /// \throws std::system_error if a thread cannot be started
+    string_type build_parallel(unsigned const thread_count = std::thread::hardware_concurrency(),
+                               std::string::size_type const threshold = default_parallel_threshold) const
+    {
+        if (thread_count < 2 or result_size < threshold or result_size == 0)
+        {
+            return build();
+        }
+
+        auto const start = now();
+        std::vector<std::string_view> segments;
+        traits::for_each_segment(storage, [&segments](std::string_view const segment)
+        {
+            segments.push_back(segment);
+        });
+        string_type result(result_size, '\0', get_allocator());
+        detail::parallel_copy(segments, result.data(), thread_count);
+        count_build(result_size, start);
+        return result;
+    }
+
+#ifdef BOSSWESTFALEN_SB_POSIX
+
+    /// \brief Describe the stored strings as buffers for `writev`.
+    ///
+    /// \note Only available on POSIX systems.
+    ///
+    /// \return One `iovec` per stored string (adjacent strings may be merged).
+    ///     The buffers are valid until the builder is changed or destroyed.
+    ///     They must not be written to.
+    std::vector<iovec> iovecs() const
+    {
+        std::vector<iovec> buffers;
+        traits::for_each_segment(storage, [&buffers](std::string_view const segment)
+        {
+            buffers.push_back(iovec{const_cast<char*>(segment.data()), segment.size()});
+        });
+        return buffers;
+    }
+
+    /// \brief Write the concatenation of the stored strings to a file descriptor.
+    ///
+    /// The stored strings are written with `writev` directly,
+    /// i.e. the result is not built in memory.
+    ///
+    /// \note Only available on POSIX systems.
+    ///
+    /// \param fd An open, blocking file descriptor (e.g. file, pipe, or socket).
+    ///     For a non-blocking one `EAGAIN` is thrown instead of waiting.
+    ///
+    /// \return Number of bytes written (the size of the result of `build()`).
+    ///
+    /// \throws std::system_error if writing fails. Some bytes may have been written already.
+    std::size_t write_to(int const fd) const
+    {
+        auto buffers = iovecs();
+        return detail::write_all(fd, buffers);
+    }
+
+    /// \brief Write the concatenation of the stored strings to a file through a memory mapping.
+    ///
+    /// The file is resized to exactly `size()` bytes (its blocks are allocated if the file system
+    /// supports it) and mapped; the stored strings are copied into the mapping directly,
+    /// by several threads if requested and the result is at least `options.threshold` bytes
+    /// (see `build_parallel()`).
+    /// The result is never built in memory, so no memory in addition to the stored strings is needed.
+    ///
+    /// \note Only available on POSIX systems.
+    ///
+    /// \param fd A regular file opened for reading and writing. Its content is replaced.
+    /// \param options How the file is written and flushed (see `mapping_options`).
+    ///
+    /// \return Number of bytes written (the size of the result of `build()`).
+    ///
+    /// \throws std::system_error if the file cannot be resized, mapped, or flushed,
+    ///     or if a thread cannot be started. The content of the file is unspecified in this case.
+    std::size_t build_to_mapping(int const fd, mapping_options const& options = {}) const
+    {
+        auto const start = now();
+        detail::resize_file(fd, result_size);
+        if (result_size != 0)
+        {
+            detail::file_mapping const mapping{fd, result_size};
+            if (options.sequential)
+            {
+                mapping.advise_sequential();
+            }
+            std::vector<std::string_view> segments;
+            traits::for_each_segment(storage, [&segments](std::string_view const segment)
+            {
+                segments.push_back(segment);
+            });
+            auto const thread_count = result_size < options.threshold ? 1u : std::max(options.thread_count, 1u);
+            detail::parallel_copy(segments, mapping.data(), thread_count);
+            mapping.sync(options.sync);
+        }
+        count_build(result_size, start);
+        return result_size;
+    }
+
+    /// \brief Write the concatenation of the stored strings to the file `path` through a memory mapping.
+    ///
+    /// The file is created if it does not exist, otherwise its content is replaced.
+    /// See `build_to_mapping()`.
+    ///
+    /// \note Only available on POSIX systems.
+    ///
+    /// \return Number of bytes written (the size of the result of `build()`).
+    ///
+    /// \throws std::system_error if the file cannot be opened or written
+    std::size_t build_to_file(std::string const& path, mapping_options const& options = {}) const
+    {
+        detail::file_descriptor const file{path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC};
+        return build_to_mapping(file.get(), options);
+    }
+
+#endif // BOSSWESTFALEN_SB_POSIX
+
+  private:
+    /// Type of the internal storage
+    using storage_type = Cont<string_type>;
+    /// Access to the internal storage
+    using traits = storage_traits<storage_type>;
+
+    /// Size of the resulting string
+    std::string::size_type result_size{0};
+    /// Internal storage
+    storage_type storage{};
+    /// Result of `build_cached()`
+    string_type cache{};
+    /// Number of fragments contained in `cache`
+    std::size_t cached_fragments{0};
+    /// Value of `first_slot` if there is no slot.
+    static constexpr std::size_t no_slot{std::numeric_limits<std::size_t>::max()};
+    /// Index of the first fragment that is a slot (see `reserve_slot()`)
+    std::size_t first_slot{no_slot};
+
+    /// \brief Account for a new fragment of `new_size`; remove it again if the result would be too large.
+    ///
+    /// \tparam Front Whether the fragment was prepended.
+    template <bool Front = false>
+    void commit(std::string::size_type const new_size)
+    {
+        static auto max_size = traits::max_size(storage);
+
+        if (result_size > max_size - new_size)
+        {
+            if constexpr (Front)
+            {
+                traits::pop_front(storage);
+            }
+            else
+            {
+                traits::pop_back(storage);
+            }
+            throw std::length_error{""};
+        }
+
+        result_size += new_size;
+        if constexpr (Front)
+        {
+            // all fragments moved by one position
+            cache.clear();
+            cached_fragments = 0;
+            if (first_slot != no_slot)
+            {
+                ++first_slot;
+            }
+        }
+    }
+
+    /// Whether `cache` is the result of `build()`.
+    bool cache_is_current() const noexcept
+    {
+        return cached_fragments == traits::size(storage) and cache.size() == result_size and first_slot == no_slot;
+    }
+
+    /// Add the concatenation of prepared arguments as a single fragment.
+    template <typename... Prepared>
+    void add_prepared(Prepared const&... arguments)
+    {
+        auto const size = detail::total_size(arguments...);
+        store([&](sink& out)
+        {
+            (arguments.write(out), ...);
+        }, size);
+    }
+
+    /// Store the fragment written by `writer` at the end, or in front if `Front` is true.
+    template <bool Front = false, typename Writer>
+    void store(Writer&& writer, std::string::size_type const size_hint = 0)
+    {
+        auto const write = [&]
+        {
+            if constexpr (Front)
+            {
+                return traits::prepend(storage, std::forward<Writer>(writer), size_hint);
+            }
+            else
+            {
+                return traits::append(storage, std::forward<Writer>(writer), size_hint);
+            }
+        };
+        count_storing<Front>(write);
+    }
+
+    /// Store `view` at the end, or in front if `Front` is true.
+    template <bool Front>
+    void store_view(std::string_view const view)
+    {
+        if constexpr (Stats::enabled)
+        {
+            Stats::on_conversion(conversion_path::view);
+        }
+        count_storing<Front>([&]
+        {
+            if constexpr (Front)
+            {
+                return traits::prepend_view(storage, view);
+            }
+            else
+            {
+                return traits::append_view(storage, view);
+            }
+        });
+    }
+
+    /// Call `write`, which stores a fragment (in front if `Front` is true) and returns its size, then commit it.
+    template <bool Front = false, typename Write>
+    void count_storing(Write&& write)
+    {
+        if constexpr (Stats::enabled)
+        {
+            auto const allocations = traits::allocations(storage);
+            auto const size = write();
+            Stats::on_allocations(traits::allocations(storage) - allocations);
+            commit<Front>(size);
+            Stats::on_fragment(size);
+        }
+        else
+        {
+            commit<Front>(write());
+        }
+    }
+
+    /// Report the conversion of a value of type `T` to `Stats`.
+    template <typename T>
+    static void count_conversion()
+    {
+        if constexpr (Stats::enabled)
+        {
+            Stats::on_conversion(detail::conversion_path_of<T>());
+        }
+    }
+
+    /// Start time of a concatenation, if `Stats` needs it.
+    static auto now() noexcept
+    {
+        if constexpr (Stats::enabled)
+        {
+            return std::chrono::steady_clock::now();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /// Report a concatenation of `bytes` that started at `start` to `Stats`.
+    template <typename Time>
+    static void count_build([[maybe_unused]] std::size_t const bytes, [[maybe_unused]] Time const start)
+    {
+        if constexpr (Stats::enabled)
+        {
+            auto const duration = std::chrono::steady_clock::now() - start;
+            Stats::on_build(bytes, static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+        }
+    }
+
+    /// Concatenate stored strings.
+    string_type concatenate() const
+    { 
+        string_type result{get_allocator()};
+        result.reserve(result_size);
+        append_segments(result);
+        return result;
+    }
+
+    /// Append the stored strings, starting at fragment `first_fragment`, to `target`.
+    void append_segments(string_type& target, std::size_t const first_fragment = 0) const
+    {
+        auto const start = now();
+        auto const old_size = target.size();
+        traits::for_each_segment(storage, [&target](std::string_view const segment)
+        {
+            target.append(segment);
+        }, first_fragment);
+        count_build(target.size() - old_size, start);
+    }
+};
+
+/// Alias to use `string_builder` with `chunked_storage`.
+using string_builder = basic_string_builder<chunked_storage>;
+
+/// `string_builder` that collects statistics (see `global_statistics()`).
+using instrumented_string_builder = basic_string_builder<chunked_storage, collect_statistics>;
+
+
+/// \brief Builders that are reused for many short tasks, e.g. one per request of a server.
+///
+/// `acquire()` hands out a builder that was used before (or a new one if none is idle).
+/// When the `lease` ends, the builder is cleared with `basic_string_builder::clear()`
+/// and kept for the next `acquire()`, so the memory of the previous tasks is reused:
+/// \code
+/// auto sb = string_builder_pool<>::local().acquire();
+/// sb->add("status: ", status);
+/// sb->build_into(response);
+/// \endcode
+///
+/// \tparam Builder The type of the builders, a default constructible `basic_string_builder`.
+///
+/// \note `string_builder_pool` is not thread-safe; use `local()`, the pool of the calling thread.
+///     A `lease` must end in the thread that acquired it.
+template <typename Builder = string_builder>
+class string_builder_pool final
+{
+  public:
+    /// \brief A builder of the pool, returned to the pool on destruction.
+    ///
+    /// The lease must end before the pool is destroyed.
+    class lease final
+    {
+      public:
+        /// Take over the builder of `other`, which is empty afterwards.
+        lease(lease&& other) noexcept
+            : pool{std::exchange(other.pool, nullptr)}
+            , builder{std::move(other.builder)}
+        {
+        }
+
+        /// Return the own builder, then take over the builder of `other`.
+        lease& operator=(lease&& other) noexcept
+        {
+            if (this != &other)
+            {
+                give_back();
+                pool = std::exchange(other.pool, nullptr);
+                builder = std::move(other.builder);
+            }
+            return *this;
+        }
+
+        /// Return the builder to the pool.
+        ~lease()
+        {
+            give_back();
+        }
+
+        /// The builder.
+        Builder& operator*() const noexcept
+        {
+            return *builder;
+        }
+
+        /// Access to the builder.
+        Builder* operator->() const noexcept
+        {
+            return builder.get();
+        }
+
+      private:
+        friend class string_builder_pool;
+
+        lease(string_builder_pool& pool, std::unique_ptr<Builder> builder) noexcept
+            : pool{&pool}
+            , builder{std::move(builder)}
+        {
+        }
+
+        /// Return the builder to the pool (if not moved away).
+        void give_back() noexcept
+        {
+            if (pool != nullptr)
+            {
+                pool->release(std::move(builder));
+                pool = nullptr;
+            }
+        }
+
+        /// The pool the builder is returned to.
+        string_builder_pool* pool;
+        /// The leased builder.
+        std::unique_ptr<Builder> builder;
+    };
+
+    /// Number of idle builders kept by default.
+    static constexpr std::size_t default_idle_limit{16};
+
+    /// \brief Create an empty pool.
+    ///
+    /// \param policy Memory that builders keep when they are returned.
+    /// \param idle_limit Maximal number of idle builders; more returned builders are destroyed.
+    explicit string_builder_pool(shrink_policy const& policy = {}, std::size_t const idle_limit = default_idle_limit)
+        : policy{policy}
+        , idle_limit{idle_limit}
+    {
+    }
+
+    string_builder_pool(string_builder_pool const&) = delete;
+    string_builder_pool& operator=(string_builder_pool const&) = delete;
+
+    /// Destroy all idle builders.
+    ~string_builder_pool() = default;
+
+    /// \brief The pool of the calling thread, created on first use with the default limits.
+    static string_builder_pool& local()
+    {
+        thread_local string_builder_pool pool;
+        return pool;
+    }
+
+    /// \brief Lease an empty builder, preferably one that was used before.
+    ///
+    /// \throws std::bad_alloc if a new builder cannot be allocated
+    lease acquire()
+    {
+        // returning the leased builders must not allocate
+        idle.reserve(std::min(idle_limit, std::max<std::size_t>(idle.size(), 1) + leased));
+        std::unique_ptr<Builder> builder;
+        if (idle.empty())
+        {
+            builder = std::make_unique<Builder>();
+        }
+        else
+        {
+            builder = std::move(idle.back());
+            idle.pop_back();
+        }
+        ++leased;
+        return lease{*this, std::move(builder)};
+    }
+
+    /// Number of idle builders.
+    std::size_t idle_count() const noexcept
+    {
+        return idle.size();
+    }
+
+    /// Number of builders that are leased.
+    std::size_t leased_count() const noexcept
+    {
+        return leased;
+    }
+
+  private:
+    /// Memory that builders keep when they are returned.
+    shrink_policy policy;
+    /// Maximal number of idle builders.
+    std::size_t idle_limit;
+    /// Builders that can be leased.
+    std::vector<std::unique_ptr<Builder>> idle{};
+    /// Number of builders that are leased.
+    std::size_t leased{0};
+
+    /// Clear `builder` and keep it for the next lease (unless there are enough idle builders).
+    void release(std::unique_ptr<Builder> builder) noexcept
+    {
+        --leased;
+        if (idle.size() < idle_limit)
+        {
+            builder->clear(policy);
+            idle.push_back(std::move(builder));
+        }
+    }
+};
+
+#ifdef BOSSWESTFALEN_SB_PMR
+
+/// \brief Builders using a `std::pmr::memory_resource`.
+///
+/// All memory (storage, stored strings, and results) comes from the resource given to the constructor,
+/// e.g. a `std::pmr::monotonic_buffer_resource` that is released at once.
+namespace pmr
+{
+
+/// `bosswestfalen::basic_string_builder` with `std::pmr::polymorphic_allocator`; use `std::pmr` containers.
+template <template <typename> typename Cont, typename Stats = no_statistics>
+using basic_string_builder = bosswestfalen::basic_string_builder<Cont, Stats, std::pmr::polymorphic_allocator<char>>;
+
+/// `string_builder` whose `build()` returns `std::pmr::string`.
+using string_builder = basic_string_builder<chunked_storage>;
+
+}
+
+#endif // BOSSWESTFALEN_SB_PMR
+
+
+/// \brief Builder that can be used by several threads at the same time.
+///
+/// Every thread appends to its own `string_builder` (a *segment*),
+/// so `add()` does not take a lock (except for the first `add()` of a thread).
+/// Segments are allocated separately and aligned to cache lines.
+///
+/// Order of the result of `build()`:
+/// * values added by the same thread appear in the order they were added
+/// * the values of a thread appear as one block; blocks are ordered
+///   by the first `add()` of each thread
+/// Values added by different threads are not interleaved.
+///
+/// \note `build()` must not be called concurrently with `add()`;
+///     all `add()` calls must happen-before (e.g. by joining the threads).
+///     `size()` can be called at any time.
+class concurrent_string_builder final
+{
+  public:
+    /// Each builder gets a unique id.
+    concurrent_string_builder()
+        : id{next_id()}
+    {
+    }
+
+    /// Threads refer to the segments, so no copies.
+    concurrent_string_builder(concurrent_string_builder const&) = delete;
+    /// Threads refer to the segments, so no copies.
+    concurrent_string_builder& operator=(concurrent_string_builder const&) = delete;
+
+    /// Nothing special to do on destruction.
+    ~concurrent_string_builder() = default;
+
+    /// \brief Add new content to the segment of the calling thread.
+    ///
+    /// See `basic_string_builder::add`.
+    template <typename... Ts>
+    void add(Ts&&... values)
+    {
+        auto& local = local_segment();
+        local.builder.add(std::forward<Ts>(values)...);
+        local.publish_size();
+    }
+
+    /// \brief Add characters without copying them to the segment of the calling thread.
+    ///
+    /// See `basic_string_builder::add_view`.
+    void add_view(std::string_view const view)
+    {
+        auto& local = local_segment();
+        local.builder.add_view(view);
+        local.publish_size();
+    }
+
+    /// \brief Size of the result of `build()`.
+    ///
+    /// Can be called while other threads add values; then it includes the values
+    /// whose `add()` has returned, i.e. it is a lower bound of the final size.
+    std::string::size_type size() const
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        std::string::size_type total{0};
+        for (auto const& segment : segments)
+        {
+            total += segment->size.load(std::memory_order_acquire);
+        }
+        return total;
+    }
+
+    /// \brief Concatenate the segments of all threads.
+    ///
+    /// The segments are copied in parallel (see `basic_string_builder::build_parallel`).
+    ///
+    /// \param thread_count Number of threads to use (including the calling thread).
+    /// \param threshold Minimal size of the result to use more than one thread.
+    ///
+    /// \return The concatenation of all added values, ordered as described above.
+    ///
+    /// \throws std::length_error if the result would be larger than `std::string::max_size()`
+    /// \throws std::system_error if a thread cannot be started
+    std::string build(unsigned const thread_count = std::thread::hardware_concurrency(),
+                      std::string::size_type const threshold = string_builder::default_parallel_threshold) const
+    {
+        std::lock_guard<std::mutex> const lock{mutex};
+        std::vector<std::string_view> views;
+        std::string::size_type total{0};
+        for (auto const& segment : segments)
+        {
+            if (total > std::string{}.max_size() - segment->builder.size())
+            {
+                throw std::length_error{""};
+            }
+            total += segment->builder.size();
+            segment->builder.for_each_segment([&views](std::string_view const view)
+            {
+                views.push_back(view);
+            });
+        }
+
+        std::string result(total, '\0');
+        if (thread_count < 2 or total < threshold)
+        {
+            detail::parallel_copy(views, result.data(), 1);
+        }
+        else
+        {
+            detail::parallel_copy(views, result.data(), thread_count);
+        }
+        return result;
+    }
+
+  private:
+    /// The values of one thread, on its own cache lines.
+    struct alignas(64) segment final
+    {
+        /// The values.
+        string_builder builder{};
+        /// Size of `builder`, readable by other threads (see `size()`).
+        std::atomic<std::string::size_type> size{0};
+
+        /// Make the size of `builder` visible to `size()`; called by the owning thread only.
+        void publish_size() noexcept
+        {
+            size.store(builder.size(), std::memory_order_release);
+        }
+    };
+
+    /// Entry of the per-thread cache that maps builders to segments.
+    struct cache_entry final
+    {
+        /// Id of the builder (0 for none).
+        std::uint64_t builder_id;
+        /// Segment of the calling thread in that builder.
+        segment* local;
+    };
+
+    /// Number of builders a thread remembers its segments for.
+    static constexpr std::size_t cache_size{8};
+
+    /// Unique id of this builder.
+    std::uint64_t const id;
+    /// Protects `segments`.
+    mutable std::mutex mutex{};
+    /// Segments in order of creation.
+    std::vector<std::unique_ptr<segment>> segments{};
+    /// Segment of each thread, identified by `thread_number()`.
+    std::vector<std::uint64_t> owners{};
+
+    /// A new unique id (never 0).
+    static std::uint64_t next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    /// Unique number of the calling thread (unlike `std::thread::id` never reused).
+    static std::uint64_t thread_number() noexcept
+    {
+        thread_local auto const number = next_id();
+        return number;
+    }
+
+    /// The segment of the calling thread; without a lock if the thread used it recently.
+    segment& local_segment()
+    {
+        thread_local std::array<cache_entry, cache_size> cache{};
+        thread_local std::size_t next_entry{0};
+
+        for (auto const& entry : cache)
+        {
+            if (entry.builder_id == id)
+            {
+                return *entry.local;
+            }
+        }
+
+        auto& local = find_or_create_segment();
+        cache[next_entry] = cache_entry{id, &local};
+        next_entry = (next_entry + 1) % cache_size;
+        return local;
+    }
+
+    /// The segment of the calling thread, created if it does not exist.
+    segment& find_or_create_segment()
+    {
+        auto const number = thread_number();
+        std::lock_guard<std::mutex> const lock{mutex};
+        auto const owner = std::find(std::cbegin(owners), std::cend(owners), number);
+        if (owner != std::cend(owners))
+        {
+            return *segments[static_cast<std::size_t>(std::distance(std::cbegin(owners), owner))];
+        }
+
+        auto created = std::make_unique<segment>();
+        owners.push_back(number);
+        try
+        {
+            segments.push_back(std::move(created));
+        }
+        catch (...)
+        {
+            owners.pop_back();
+            throw;
+        }
+        return *segments.back();
+    }
+};
+
+
+/// \brief Output of a `basic_streaming_string_builder` that writes to a `std::ostream`.
+class ostream_output final
+{
+  public:
+    /// \brief Write to `stream`, which must outlive the output.
+    explicit ostream_output(std::ostream& stream) noexcept
+        : stream{&stream}
+    {
+    }
+
+    /// \brief Write `text` to the stream.
+    ///
+    /// \throws std::ios_base::failure if the stream is in a failed state afterwards
+    void operator()(std::string_view const text) const
+    {
+        stream->write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (not *stream)
+        {
+            throw std::ios_base::failure{"ostream_output: write failed"};
+        }
+    }
+
+  private:
+    /// The stream written to.
+    std::ostream* stream;
+};
+
+#ifdef BOSSWESTFALEN_SB_POSIX
+
+/// \brief Output of a `basic_streaming_string_builder` that writes to a file descriptor.
+///
+/// \note Only available on POSIX systems.
+class fd_output final
+{
+  public:
+    /// \brief Write to the open, blocking file descriptor `fd`; it is not closed.
+    explicit fd_output(int const fd) noexcept
+        : fd{fd}
+    {
+    }
+
+    /// \brief Write `text` to the file descriptor.
+    ///
+    /// \throws std::system_error if writing fails
+    void operator()(std::string_view const text) const
+    {
+        std::vector<iovec> buffers{iovec{const_cast<char*>(text.data()), text.size()}};
+        detail::write_all(fd, buffers);
+    }
+
+  private:
+    /// The file descriptor written to.
+    int fd;
+};
+
+#endif // BOSSWESTFALEN_SB_POSIX
+
+/// \brief Builder that passes its content to an output instead of keeping it.
+///
+/// Added values are converted like in `basic_string_builder::add` and collected
+/// in a buffer. As soon as the buffer holds `high_water_mark` or more characters,
+/// it is flushed to the output. Memory usage therefore does not depend on the
+/// total amount of added characters.
+///
+/// Remaining characters are flushed on destruction; errors are ignored then.
+/// Call `flush()` to handle them.
+///
+/// \tparam Output Callable with signature `void(std::string_view)`,
+///     e.g. `ostream_output`, `fd_output`, or a lambda.
+///
+/// \note `basic_streaming_string_builder` is not thread-safe.
+template <typename Output>
+class basic_streaming_string_builder final
+{
+  public:
+    /// Type used for sizes.
+    using size_type = std::string::size_type;
+
+    /// Default number of buffered characters that triggers a flush.
+    static constexpr size_type default_high_water_mark{64 * 1024};
+
+    /// \brief Create a builder writing to `output`.
+    ///
+    /// \param output The output receiving the characters.
+    /// \param high_water_mark Number of buffered characters that triggers a flush.
+    explicit basic_streaming_string_builder(Output output, size_type const high_water_mark = default_high_water_mark)
+        : output{std::move(output)}
+        , high_water_mark{high_water_mark}
+    {
+    }
+
+    /// No copies, they would write the same characters twice.
+    basic_streaming_string_builder(basic_streaming_string_builder const&) = delete;
+    /// No copies, they would write the same characters twice.
+    basic_streaming_string_builder& operator=(basic_streaming_string_builder const&) = delete;
+
+    /// Flush remaining characters, errors are ignored.
+    ~basic_streaming_string_builder()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /// \brief Add new content.
+    ///
+    /// The conversion rules of `append_to` are used.
+    /// The buffer is flushed afterwards if it reached the high-water mark.
+    ///
+    /// \throws any exception that occurs during conversion (nothing is added then)
+    ///     or during `flush()`
+    template <typename T>
+    void add(T&& value)
+    {
+        auto const old_size = buffer.size();
+        string_sink out{buffer};
+        try
+        {
+            append_to(out, std::forward<T>(value));
+        }
+        catch (...)
+        {
+            buffer.resize(old_size);
+            throw;
+        }
+        flush_if_needed();
+    }
+
+    /// \brief Add several values (see `add(T&&)`).
+    template <typename T, typename U, typename... Ts>
+    void add(T&& first, U&& second, Ts&&... rest)
+    {
+        add(std::forward<T>(first));
+        add(std::forward<U>(second));
+        (add(std::forward<Ts>(rest)), ...);
+    }
+
+    /// \brief Add characters; large views are passed to the output without buffering.
+    void add_view(std::string_view const view)
+    {
+        if (view.size() < high_water_mark)
+        {
+            buffer.append(view);
+            flush_if_needed();
+            return;
+        }
+        flush();
+        output(view);
+        written += view.size();
+    }
+
+    /// \brief Pass all buffered characters to the output.
+    ///
+    /// \throws any exception thrown by the output. The buffer is unchanged in this case.
+    void flush()
+    {
+        if (buffer.empty())
+        {
+            return;
+        }
+        output(std::string_view{buffer});
+        written += buffer.size();
+        buffer.clear();
+    }
+
+    /// Number of characters passed to the output so far.
+    size_type bytes_written() const noexcept
+    {
+        return written;
+    }
+
+    /// Number of characters waiting for the next flush.
+    size_type bytes_buffered() const noexcept
+    {
+        return buffer.size();
+    }
+
+  private:
+    /// Receives the characters.
+    Output output;
+    /// Number of buffered characters that triggers a flush.
+    size_type high_water_mark;
+    /// Characters not flushed so far.
+    std::string buffer{};
+    /// Number of characters flushed so far.
+    size_type written{0};
+
+    /// Flush if the high-water mark is reached.
+    void flush_if_needed()
+    {
+        if (buffer.size() >= high_water_mark)
+        {
+            flush();
+        }
+    }
+};
+
+/// Alias to use a `basic_streaming_string_builder` with any output.
+using streaming_string_builder = basic_streaming_string_builder<std::function<void(std::string_view)>>;
+
+
+/// \brief What `static_string_builder` does if its capacity is exceeded.
+enum class overflow_policy
+{
+    /// Throw `std::length_error` and keep the content (like `basic_string_builder::add`).
+    exception,
+    /// Keep as many characters as fit and drop the rest.
+    truncate,
+    /// Move the content to a `std::string` on the heap and continue there.
+    spill
+};
+
+namespace detail
+{
+
+/// Heap storage of a `static_string_builder` that may spill.
+template <bool Enabled>
+struct spill_storage
+{
+    /// Content after spilling.
+    std::string text{};
+    /// Whether the content was moved to `text`.
+    bool used{false};
+};
+
+/// No heap storage for `static_string_builder` that does not spill.
+template <>
+struct spill_storage<false>
+{
+};
+
+}
+
+/// \brief Builder with a fixed capacity that keeps its content in an inline buffer.
+///
+/// Offers the `add()` / `build()` interface and conversion rules of `basic_string_builder`,
+/// but all characters are written directly into a `char[N]` member.
+/// Unless the capacity is exceeded with `overflow_policy::spill`, the heap is never used.
+///
+/// Strings, string literals, and integral values can be added in constant expressions:
+/// \code
+/// constexpr auto header = []
+/// {
+///     bosswestfalen::static_string_builder<32> sb;
+///     sb.add("version=");
+///     sb.add(2);
+///     return sb;
+/// }();
+/// static_assert(header.view() == "version=2");
+/// \endcode
+///
+/// \tparam N The capacity in characters.
+/// \tparam Policy What happens if the capacity is exceeded (see `overflow_policy`).
+///
+/// \note `static_string_builder` is not thread-safe.
+template <std::size_t N, overflow_policy Policy = overflow_policy::exception>
+class static_string_builder final
+{
+  public:
+    /// Type used for sizes.
+    using size_type = std::size_t;
+
+    /// Default Ctor is sufficient.
+    constexpr static_string_builder() noexcept = default;
+
+    /// \brief Add new content.
+    ///
+    /// The conversion rules of `append_to` are used.
+    /// Strings and integral values are written without a `sink`, so that
+    /// they can be added in constant expressions.
+    ///
+    /// \tparam T The type of the input value.
+    /// \param value The value that will be written into the buffer.
+    ///
+    /// \throws std::length_error if `Policy` is `overflow_policy::exception`
+    ///     and the capacity would be exceeded. The content is unchanged in this case.
+    /// \throws any exception that occurs during the conversion
+    template <typename T>
+    constexpr void add(T&& value)
+    {
+        if constexpr (std::is_convertible_v<T const&, std::string_view>)
+        {
+            write(std::string_view{value});
+        }
+        else if constexpr (std::is_integral_v<std::remove_reference_t<T>>)
+        {
+            auto const promoted = +value;
+            char digits[std::numeric_limits<decltype(promoted)>::digits10 + 3]{};
+            auto const first = detail::format_decimal(digits, promoted);
+            write(std::string_view{digits + first, sizeof(digits) - first});
+        }
+        else
+        {
+            add_converted(std::forward<T>(value));
+        }
+    }
+
+    /// \brief The content as `std::string_view`.
+    ///
+    /// Valid until the builder is changed or destroyed.
+    constexpr std::string_view view() const noexcept
+    {
+        if constexpr (Policy == overflow_policy::spill)
+        {
+            if (spill.used)
+            {
+                return std::string_view{spill.text};
+            }
+        }
+        return std::string_view{buffer, length};
+    }
+
+    /// \brief The content as `std::string`.
+    ///
+    /// No allocation is needed if the content fits into the small string buffer.
+    std::string build() const
+    {
+        return std::string{view()};
+    }
+
+    /// Number of characters added so far.
+    constexpr size_type size() const noexcept
+    {
+        return view().size();
+    }
+
+    /// Number of characters that fit into the inline buffer.
+    static constexpr size_type capacity() noexcept
+    {
+        return N;
+    }
+
+    /// Whether characters were dropped because of `overflow_policy::truncate`.
+    constexpr bool truncated() const noexcept
+    {
+        return was_truncated;
+    }
+
+  private:
+    /// `sink` writing to the builder.
+    class buffer_sink final : public sink
+    {
+      public:
+        explicit buffer_sink(static_string_builder& builder) noexcept
+            : builder{builder}
+        {
+        }
+
+      private:
+        /// The builder written to.
+        static_string_builder& builder;
+
+        void do_append(char const* data, std::size_t count) override
+        {
+            builder.write_copy(std::string_view{data, count});
+        }
+    };
+
+    /// The inline buffer.
+    char buffer[N]{};
+    /// Number of characters in `buffer`.
+    size_type length{0};
+    /// Whether characters were dropped.
+    bool was_truncated{false};
+    /// Heap storage for `overflow_policy::spill`.
+    detail::spill_storage<Policy == overflow_policy::spill> spill{};
+
+    /// Write `text` according to `Policy`.
+    constexpr void write(std::string_view text)
+    {
+        if (fit(text))
+        {
+            for (size_type i{0}; i < text.size(); ++i)
+            {
+                buffer[length + i] = text[i];
+            }
+            length += text.size();
+        }
+    }
+
+    /// \brief Write `text` according to `Policy` with a single copy (used by `buffer_sink`).
+    ///
+    /// Not usable in constant expressions before C++20.
+    void write_copy(std::string_view text)
+    {
+        if (fit(text))
+        {
+            std::char_traits<char>::copy(buffer + length, text.data(), text.size());
+            length += text.size();
+        }
+    }
+
+    /// \brief Apply `Policy` to `text`.
+    ///
+    /// \return Whether `text` (possibly truncated) fits into `buffer` and still has to be copied there.
+    constexpr bool fit(std::string_view& text)
+    {
+        if constexpr (Policy == overflow_policy::spill)
+        {
+            if (spill.used)
+            {
+                spill.text.append(text);
+                return false;
+            }
+            if (text.size() > N - length)
+            {
+                spill.text.reserve(length + text.size());
+                spill.text.assign(buffer, length);
+                spill.text.append(text);
+                spill.used = true;
+                return false;
+            }
+        }
+        else if constexpr (Policy == overflow_policy::truncate)
+        {
+            if (text.size() > N - length)
+            {
+                text = text.substr(0, N - length);
+                was_truncated = true;
+            }
+        }
+        else
+        {
+            if (text.size() > N - length)
+            {
+                throw std::length_error{""};
+            }
+        }
+        return true;
+    }
+
+    /// Write `value` with `append_to`; remove partially written characters on failure.
+    template <typename T>
+    void add_converted(T&& value)
+    {
+        auto const old_size = size();
+        buffer_sink out{*this};
+        try
+        {
+            append_to(out, std::forward<T>(value));
+        }
+        catch (...)
+        {
+            shrink(old_size);
+            throw;
+        }
+    }
+
+    /// Drop all characters after the first `new_size`.
+    void shrink(size_type const new_size)
+    {
+        if constexpr (Policy == overflow_policy::spill)
+        {
+            if (spill.used)
+            {
+                spill.text.resize(new_size);
+                return;
+            }
+        }
+        length = new_size;
+    }
+};
 
 }
 
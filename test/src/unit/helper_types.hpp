@@ -2,6 +2,7 @@
 #define BOSSWESTFALEN_UNIT_TEST_HELPER_TYPES_HPP
 
 #include <ostream>
+#include <string_builder.hpp>
 
 namespace test_type
 {
@@ -52,6 +53,33 @@ struct has_explicit_operator_string final
     }
 };
 
+
+struct has_sb_append final
+{
+    int value{42};
+};
+
+void sb_append(bosswestfalen::sink& out, has_sb_append const& x)
+{
+    out.append("sb_append:");
+    bosswestfalen::append_to(out, x.value);
+}
+
+
+struct has_sb_append_and_to_string final
+{
+};
+
+void sb_append(bosswestfalen::sink& out, has_sb_append_and_to_string const&)
+{
+    out.append("sb_append");
+}
+
+std::string to_string(has_sb_append_and_to_string const&)
+{
+    return "external_to_string";
+}
+
 }
 
 #endif
@@ -0,0 +1,87 @@
+#include <catch.hpp>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+TEST_CASE("append to sink")
+{
+    std::string target{"prefix:"};
+    bosswestfalen::string_sink out{target};
+
+    SECTION("raw characters")
+    {
+        out.append("abc", 2);
+        out.append(std::string_view{"cd"});
+        out.push_back('!');
+        CHECK(std::string{"prefix:abcd!"} == target);
+    }
+
+    SECTION("built-in types use the built-in hooks")
+    {
+        bosswestfalen::append_to(out, 10);
+        bosswestfalen::append_to(out, std::string{"cat"});
+        bosswestfalen::append_to(out, "dog");
+        bosswestfalen::append_to(out, std::string_view{"fish"});
+        CHECK(std::string{"prefix:10catdogfish"} == target);
+    }
+
+    SECTION("integral types are written like std::to_string")
+    {
+        bosswestfalen::append_to(out, -1234567890123LL);
+        bosswestfalen::append_to(out, 'a');
+        bosswestfalen::append_to(out, false);
+        CHECK(std::string{"prefix:"} + std::to_string(-1234567890123LL) + std::to_string('a')
+              + std::to_string(false) == target);
+    }
+
+    SECTION("floating point types are written in the shortest round-trip form")
+    {
+        bosswestfalen::append_to(out, 1.5f);
+        bosswestfalen::append_to(out, " ");
+        bosswestfalen::append_to(out, 1e300);
+        bosswestfalen::append_to(out, " ");
+        bosswestfalen::append_to(out, -2.25L);
+        bosswestfalen::append_to(out, " ");
+        bosswestfalen::append_to(out, 0.1);
+        CHECK(std::string{"prefix:1.5 1e+300 -2.25 0.1"} == target);
+    }
+
+    SECTION("custom hook")
+    {
+        bosswestfalen::append_to(out, test_type::has_sb_append{});
+        CHECK(std::string{"prefix:sb_append:42"} == target);
+    }
+
+    SECTION("fallbacks")
+    {
+        bosswestfalen::append_to(out, test_type::has_external_to_string{});
+        bosswestfalen::append_to(out, test_type::has_operator_ll{});
+        CHECK(std::string{"prefix:external_to_stringstream"} == target);
+    }
+}
+
+TEST_CASE("sb_append has priority over to_string")
+{
+    CHECK(std::string{"sb_append"} == bosswestfalen::make_string(test_type::has_sb_append_and_to_string{}));
+}
+
+SCENARIO("adding types with sb_append")
+{
+    GIVEN("a string_builder")
+    {
+        bosswestfalen::string_builder sb;
+
+        WHEN("a type with a custom hook is added")
+        {
+            sb.add("x=");
+            sb.add(test_type::has_sb_append{7});
+
+            THEN("the hook is used")
+            {
+                CHECK(std::string{"x=sb_append:7"} == sb.build());
+            }
+        }
+    }
+}
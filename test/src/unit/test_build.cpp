@@ -1,4 +1,7 @@
 #include <catch.hpp>
+#include <deque>
+#include <string>
+#include <utility>
 #include <string_builder.hpp>
 
 SCENARIO("building strings")
@@ -59,3 +62,107 @@ SCENARIO("building strings")
     }
 }
 
+
+SCENARIO("building into an existing string")
+{
+    GIVEN("a string_builder with content and a string with capacity")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("cat");
+        sb.add(1);
+        std::string target(1000, 'x');
+        auto const capacity = target.capacity();
+        auto const data = target.data();
+
+        WHEN("the result is built into the string")
+        {
+            sb.build_into(target);
+
+            THEN("the content is replaced and the memory is reused")
+            {
+                CHECK(std::string{"cat1"} == target);
+                CHECK(capacity == target.capacity());
+                CHECK(data == target.data());
+            }
+        }
+    }
+}
+
+SCENARIO("taking the result")
+{
+    GIVEN("a string_builder using std::deque with a single string")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        std::string const long_text(100, 'l');
+        sb.add(long_text);
+
+        WHEN("the result is taken")
+        {
+            auto const result = std::move(sb).build();
+
+            THEN("the builder is empty afterwards")
+            {
+                CHECK(long_text == result);
+                CHECK(std::string{} == sb.build());
+            }
+        }
+    }
+
+    GIVEN("a string_builder with several strings")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("cat");
+        sb.add("dog");
+
+        WHEN("the result is taken")
+        {
+            auto const result = sb.take();
+
+            THEN("the builder is empty and can be reused")
+            {
+                CHECK(std::string{"catdog"} == result);
+                CHECK(std::string{} == sb.build());
+                sb.add("fish");
+                CHECK(std::string{"fish"} == sb.build());
+            }
+        }
+
+        WHEN("the result is cached and taken")
+        {
+            std::string const long_text(100, 'l');
+            sb.add(long_text);
+            auto const data = sb.build_cached().data();
+            auto const result = sb.take();
+
+            THEN("the cached result is moved")
+            {
+                CHECK(std::string{"catdog"} + long_text == result);
+                CHECK(data == result.data());
+            }
+        }
+    }
+}
+
+SCENARIO("building with cache")
+{
+    GIVEN("a string_builder with content")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("cat");
+
+        WHEN("the cached result is requested repeatedly")
+        {
+            CHECK(std::string{"cat"} == sb.build_cached());
+            sb.add("dog");
+            CHECK(std::string{"catdog"} == sb.build_cached());
+            sb.add(1);
+            sb.add(2);
+
+            THEN("new content is appended")
+            {
+                CHECK(std::string{"catdog12"} == sb.build_cached());
+                CHECK(std::string{"catdog12"} == sb.build());
+            }
+        }
+    }
+}
@@ -0,0 +1,207 @@
+#include <catch.hpp>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+/// Temporary file that is removed on destruction.
+class temporary_file final
+{
+  public:
+    temporary_file()
+        : fd{::mkstemp(name)}
+    {
+        REQUIRE(fd >= 0);
+    }
+
+    temporary_file(temporary_file const&) = delete;
+    temporary_file& operator=(temporary_file const&) = delete;
+
+    ~temporary_file()
+    {
+        ::close(fd);
+        ::unlink(name);
+    }
+
+    std::string path() const
+    {
+        return name;
+    }
+
+    int get() const noexcept
+    {
+        return fd;
+    }
+
+    /// The whole content of the file.
+    std::string content() const
+    {
+        std::string result;
+        char buffer[4096];
+        for (off_t offset{0};; offset += static_cast<off_t>(sizeof(buffer)))
+        {
+            auto const count = ::pread(fd, buffer, sizeof(buffer), offset);
+            if (count <= 0)
+            {
+                return result;
+            }
+            result.append(buffer, static_cast<std::size_t>(count));
+        }
+    }
+
+    /// The size of the file.
+    std::size_t size() const
+    {
+        struct stat status{};
+        REQUIRE(::fstat(fd, &status) == 0);
+        return static_cast<std::size_t>(status.st_size);
+    }
+
+  private:
+    char name[32]{"/tmp/string_builder_XXXXXX"};
+    int fd;
+};
+
+}
+
+
+SCENARIO("writing to a memory mapped file")
+{
+    GIVEN("a string_builder with content")
+    {
+        bosswestfalen::string_builder sb;
+        auto const header = sb.reserve_slot(8);
+        for (int i{0}; i < 100000; ++i)
+        {
+            sb.add(i);
+        }
+        sb.prepend_view("numbers:");
+        header.fill(sb.size());
+        auto const expected = sb.build();
+        temporary_file file;
+
+        WHEN("it is written to a file descriptor")
+        {
+            auto const written = sb.build_to_mapping(file.get());
+
+            THEN("the file contains the result of build()")
+            {
+                CHECK(written == expected.size());
+                CHECK(file.size() == expected.size());
+                CHECK(file.content() == expected);
+            }
+        }
+
+        WHEN("it is written to a file with more content")
+        {
+            REQUIRE(::write(file.get(), std::string(expected.size() * 2, 'x').data(), expected.size() * 2) > 0);
+            sb.build_to_mapping(file.get());
+
+            THEN("the file is truncated")
+            {
+                CHECK(file.size() == expected.size());
+                CHECK(file.content() == expected);
+            }
+        }
+
+        WHEN("it is written by several threads and synchronized")
+        {
+            for (auto const sync : {bosswestfalen::mapping_sync::none, bosswestfalen::mapping_sync::async,
+                                    bosswestfalen::mapping_sync::sync})
+            {
+                sb.build_to_mapping(file.get(), bosswestfalen::mapping_options{sync, false, 4, 0});
+                CHECK(file.content() == expected);
+            }
+        }
+
+        WHEN("it is smaller than the threshold for several threads")
+        {
+            sb.build_to_mapping(file.get(), bosswestfalen::mapping_options{bosswestfalen::mapping_sync::none, false, 4});
+
+            THEN("it is written like with one thread")
+            {
+                CHECK(file.content() == expected);
+            }
+        }
+
+        WHEN("it is written to a path")
+        {
+            auto const written = sb.build_to_file(file.path());
+
+            THEN("the file contains the result of build()")
+            {
+                CHECK(written == expected.size());
+                CHECK(file.content() == expected);
+            }
+        }
+
+        WHEN("it is written to an invalid path")
+        {
+            THEN("std::system_error is thrown")
+            {
+                CHECK_THROWS_AS(sb.build_to_file("/nonexistent/directory/file"), std::system_error);
+            }
+        }
+
+        WHEN("it is written to an invalid file descriptor")
+        {
+            THEN("std::system_error is thrown")
+            {
+                CHECK_THROWS_AS(sb.build_to_mapping(-1), std::system_error);
+            }
+        }
+
+        WHEN("it is written to a file that is not readable")
+        {
+            auto const fd = ::open(file.path().c_str(), O_WRONLY);
+            REQUIRE(fd >= 0);
+
+            THEN("std::system_error is thrown")
+            {
+                CHECK_THROWS_AS(sb.build_to_mapping(fd), std::system_error);
+            }
+            ::close(fd);
+        }
+    }
+
+    GIVEN("a string_builder with std::deque as storage")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        for (int i{0}; i < 1000; ++i)
+        {
+            sb.add(i, ",");
+        }
+        temporary_file file;
+        sb.build_to_file(file.path(), bosswestfalen::mapping_options{bosswestfalen::mapping_sync::sync, true, 2});
+
+        THEN("the file contains the result of build()")
+        {
+            CHECK(file.content() == sb.build());
+        }
+    }
+
+    GIVEN("an empty string_builder")
+    {
+        bosswestfalen::string_builder sb;
+        temporary_file file;
+        REQUIRE(::write(file.get(), "content", 7) == 7);
+
+        WHEN("it is written to a file")
+        {
+            CHECK(sb.build_to_mapping(file.get()) == 0);
+
+            THEN("the file is empty")
+            {
+                CHECK(file.size() == 0);
+            }
+        }
+    }
+}
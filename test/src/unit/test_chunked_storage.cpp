@@ -0,0 +1,135 @@
+#include <catch.hpp>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+using storage_type = bosswestfalen::chunked_storage<std::string>;
+
+/// writes `count` times `character` with one append per character
+struct piecewise final
+{
+    std::size_t count;
+    char character;
+};
+
+void sb_append(bosswestfalen::sink& out, piecewise const& x)
+{
+    for (std::size_t i{0}; i < x.count; ++i)
+    {
+        out.push_back(x.character);
+    }
+}
+
+/// writes some characters, then throws
+struct throwing final
+{
+};
+
+void sb_append(bosswestfalen::sink& out, throwing const&)
+{
+    out.append(std::string(100, 'x'));
+    throw std::runtime_error{"throwing"};
+}
+
+}
+
+
+SCENARIO("chunked storage")
+{
+    GIVEN("a string_builder using chunked_storage")
+    {
+        bosswestfalen::string_builder sb;
+        std::string expected;
+
+        WHEN("many small fragments are added")
+        {
+            for (int i{0}; i < 10000; ++i)
+            {
+                sb.add(i);
+                expected += std::to_string(i);
+            }
+
+            THEN("the result is their concatenation")
+            {
+                CHECK(expected == sb.build());
+            }
+        }
+
+        WHEN("a fragment is larger than a chunk")
+        {
+            std::string const large(3 * storage_type::maximal_chunk_size + 1, 'l');
+            sb.add("a");
+            sb.add(large);
+            sb.add("b");
+
+            THEN("it is stored completely")
+            {
+                CHECK(std::string{"a"} + large + "b" == sb.build());
+            }
+        }
+
+        WHEN("a fragment written piecewise crosses a chunk boundary")
+        {
+            std::string const filler(storage_type::initial_chunk_size - 10, 'f');
+            sb.add(filler);
+            sb.add(piecewise{100, 'p'});
+            sb.add("end");
+
+            THEN("the fragment stays intact")
+            {
+                CHECK(filler + std::string(100, 'p') + "end" == sb.build());
+            }
+        }
+
+        WHEN("writing a fragment fails")
+        {
+            sb.add("cat");
+            CHECK_THROWS_AS(sb.add(throwing{}), std::runtime_error);
+            sb.add("dog");
+
+            THEN("the partially written fragment is discarded")
+            {
+                CHECK(std::string{"catdog"} == sb.build());
+            }
+        }
+
+        WHEN("the builder is copied and moved")
+        {
+            sb.add("cat");
+            sb.add(piecewise{storage_type::initial_chunk_size, 'c'});
+            auto copy{sb};
+            copy.add("dog");
+            auto moved{std::move(sb)};
+            moved.add("fish");
+
+            THEN("the builders are independent")
+            {
+                auto const cats = std::string{"cat"} + std::string(storage_type::initial_chunk_size, 'c');
+                CHECK(cats + "dog" == copy.build());
+                CHECK(cats + "fish" == moved.build());
+            }
+        }
+    }
+
+    GIVEN("a string_builder using std::deque")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+
+        WHEN("strings are added")
+        {
+            sb.add("cat");
+            sb.add(1);
+            sb.add(piecewise{3, 'x'});
+
+            THEN("the result is their concatenation")
+            {
+                CHECK(std::string{"cat1xxx"} == sb.build());
+            }
+        }
+    }
+}
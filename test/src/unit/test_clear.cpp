@@ -0,0 +1,350 @@
+#include <catch.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+using storage_type = bosswestfalen::chunked_storage<std::string>;
+
+/// Number of calls of the global `operator new`.
+std::atomic<std::size_t> global_allocations{0};
+
+/// The numbers below `count`, each followed by a comma.
+std::string numbers(int const count)
+{
+    std::string result;
+    for (int i{0}; i < count; ++i)
+    {
+        result += std::to_string(i) + ",";
+    }
+    return result;
+}
+
+/// Add the numbers below `count`, each followed by a comma (see `numbers()`); does not allocate itself.
+template <typename Builder>
+void fill(Builder& sb, int const count)
+{
+    for (int i{0}; i < count; ++i)
+    {
+        sb.add(i, ",");
+    }
+}
+
+}
+
+// AddressSanitizer replaces operator new itself, no counting then
+#ifndef __SANITIZE_ADDRESS__
+
+void* operator new(std::size_t const size)
+{
+    ++global_allocations;
+    if (auto const memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* const memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+#endif
+
+
+SCENARIO("clearing a builder")
+{
+    GIVEN("a string_builder with content")
+    {
+        bosswestfalen::string_builder sb;
+        fill(sb, 10000);
+        sb.prepend("first");
+        sb.build_cached();
+
+        WHEN("it is cleared")
+        {
+            sb.clear();
+
+            THEN("it is empty")
+            {
+                CHECK(sb.size() == 0);
+                CHECK(sb.build().empty());
+                CHECK(sb.build_cached().empty());
+            }
+
+            THEN("it can be used again")
+            {
+                auto const header = sb.reserve_slot(3, '-');
+                fill(sb, 100);
+                sb.prepend_view("numbers:");
+                header.fill(7);
+                CHECK(sb.build() == "numbers:7--" + numbers(100));
+                CHECK(sb.build_cached() == "numbers:7--" + numbers(100));
+            }
+        }
+
+        WHEN("it is filled again after clear()")
+        {
+            std::string result;
+            sb.clear();
+            fill(sb, 10000);
+            sb.build_into(result);
+
+            auto const before = global_allocations.load();
+            sb.clear();
+            fill(sb, 10000);
+            sb.build_into(result);
+            auto const allocations = global_allocations.load() - before;
+
+            THEN("nothing is allocated")
+            {
+                CHECK(allocations == 0);
+                CHECK(result == numbers(10000));
+            }
+        }
+
+        WHEN("it is cleared without keeping memory")
+        {
+            sb.clear(bosswestfalen::shrink_policy{0, 0});
+
+            THEN("it is empty")
+            {
+                CHECK(sb.size() == 0);
+                CHECK(sb.build().empty());
+                fill(sb, 100);
+                CHECK(sb.build() == numbers(100));
+            }
+        }
+    }
+
+    GIVEN("a builder with std::deque as storage")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        fill(sb, 1000);
+        sb.clear();
+
+        THEN("it is empty and can be used again")
+        {
+            CHECK(sb.size() == 0);
+            CHECK(sb.build().empty());
+            fill(sb, 10);
+            CHECK(sb.build() == numbers(10));
+        }
+    }
+}
+
+
+TEST_CASE("chunked_storage keeps chunks on reset()")
+{
+    std::string const large(1000, 'x');
+
+    SECTION("all chunks are reused")
+    {
+        storage_type storage;
+        for (int i{0}; i < 200; ++i)
+        {
+            storage.append_view(large);
+            storage.append([&large](bosswestfalen::sink& out)
+            {
+                out.append(large);
+            });
+        }
+        auto const chunks = storage.chunk_count();
+        REQUIRE(chunks > 1);
+
+        storage.reset(std::numeric_limits<storage_type::size_type>::max());
+        CHECK(storage.empty());
+        CHECK(storage.chunk_count() == chunks);
+
+        for (int i{0}; i < 200; ++i)
+        {
+            storage.append([&large](bosswestfalen::sink& out)
+            {
+                out.append(large);
+            });
+        }
+        CHECK(storage.chunk_count() == chunks);
+        std::string result;
+        storage.for_each_segment([&result](std::string_view const segment)
+        {
+            result += segment;
+        });
+        CHECK(result == [&large]
+        {
+            std::string repeated;
+            for (int i{0}; i < 200; ++i)
+            {
+                repeated += large;
+            }
+            return repeated;
+        }());
+    }
+
+    SECTION("chunks beyond the retained capacity are released")
+    {
+        storage_type storage;
+        for (int i{0}; i < 100; ++i)
+        {
+            storage.append_slot(1000, 'x');
+        }
+        REQUIRE(storage.chunk_count() > 2);
+
+        storage.reset(storage_type::initial_chunk_size);
+        CHECK(storage.chunk_count() == 1);
+        storage.reset(0);
+        CHECK(storage.chunk_count() == 0);
+    }
+
+    SECTION("a fragment larger than the kept chunks gets a new chunk")
+    {
+        storage_type storage;
+        storage.append_slot(10, 'a');
+        storage.reset(std::numeric_limits<storage_type::size_type>::max());
+        storage.append_slot(10, 'b');
+        std::string const huge(2 * storage_type::maximal_chunk_size, 'h');
+        storage.append([&huge](bosswestfalen::sink& out)
+        {
+            out.append(huge);
+        });
+        storage.append_slot(10, 'c');
+
+        std::string result;
+        storage.for_each_segment([&result](std::string_view const segment)
+        {
+            result += segment;
+        });
+        CHECK(result == std::string(10, 'b') + huge + std::string(10, 'c'));
+        CHECK(storage.chunk_count() == 3);
+    }
+}
+
+
+SCENARIO("string_builder_pool")
+{
+    GIVEN("a pool")
+    {
+        bosswestfalen::string_builder_pool<> pool;
+
+        WHEN("a builder is leased and returned")
+        {
+            bosswestfalen::string_builder* used{nullptr};
+            {
+                auto sb = pool.acquire();
+                CHECK(pool.leased_count() == 1);
+                fill(*sb, 100);
+                used = &*sb;
+            }
+
+            THEN("it is idle and cleared")
+            {
+                CHECK(pool.leased_count() == 0);
+                REQUIRE(pool.idle_count() == 1);
+                auto sb = pool.acquire();
+                CHECK(&*sb == used);
+                CHECK(sb->size() == 0);
+                CHECK(sb->build().empty());
+            }
+        }
+
+        WHEN("several builders are leased at the same time")
+        {
+            auto first = pool.acquire();
+            auto second = pool.acquire();
+            first->add("first");
+            second->add("second");
+
+            THEN("they are different")
+            {
+                CHECK(&*first != &*second);
+                CHECK(first->build() == "first");
+                CHECK(second->build() == "second");
+            }
+        }
+
+        WHEN("a lease is moved")
+        {
+            auto first = pool.acquire();
+            first->add("content");
+            auto second = std::move(first);
+            auto third = pool.acquire();
+            third = std::move(second);
+
+            THEN("the builder is returned once")
+            {
+                CHECK(third->build() == "content");
+                CHECK(pool.leased_count() == 1);
+                CHECK(pool.idle_count() == 1);
+            }
+        }
+
+        WHEN("requests are handled with warm builders")
+        {
+            std::string response;
+            for (int i{0}; i < 3; ++i)
+            {
+                auto sb = pool.acquire();
+                fill(*sb, 1000);
+                sb->build_into(response);
+            }
+
+            auto const before = global_allocations.load();
+            for (int i{0}; i < 3; ++i)
+            {
+                auto sb = pool.acquire();
+                fill(*sb, 1000);
+                sb->build_into(response);
+            }
+            auto const allocations = global_allocations.load() - before;
+
+            THEN("nothing is allocated")
+            {
+                CHECK(allocations == 0);
+            }
+        }
+    }
+
+    GIVEN("a pool with a limit of idle builders")
+    {
+        bosswestfalen::string_builder_pool<> pool{{}, 1};
+        {
+            auto first = pool.acquire();
+            auto second = pool.acquire();
+        }
+
+        THEN("more builders are destroyed")
+        {
+            CHECK(pool.idle_count() == 1);
+        }
+    }
+
+    GIVEN("the pools of two threads")
+    {
+        auto const main = &bosswestfalen::string_builder_pool<>::local();
+        bosswestfalen::string_builder_pool<>* other{nullptr};
+        std::thread{[&other]
+        {
+            other = &bosswestfalen::string_builder_pool<>::local();
+        }}.join();
+
+        THEN("they are different")
+        {
+            CHECK(main == &bosswestfalen::string_builder_pool<>::local());
+            CHECK(main != other);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+TEST_CASE("concat")
+{
+    SECTION("no values")
+    {
+        CHECK(std::string{} == bosswestfalen::concat());
+    }
+
+    SECTION("strings")
+    {
+        std::string const cat{"cat"};
+        char const* dog{"dog"};
+        CHECK(std::string{"catdogfishbird"} == bosswestfalen::concat(cat, dog, "fish", std::string_view{"bird"}));
+    }
+
+    SECTION("arithmetic types")
+    {
+        CHECK(std::string{"1-20.51e+300"} == bosswestfalen::concat(true, -2, 0.5, 1e300));
+    }
+
+    SECTION("all conversion paths")
+    {
+        CHECK(std::string{"user=42 sb_append:7 external_to_string stream operator_to_string 1234"}
+              == bosswestfalen::concat("user=", 42,
+                                       " ", test_type::has_sb_append{7},
+                                       " ", test_type::has_external_to_string{},
+                                       " ", test_type::has_operator_ll{},
+                                       " ", test_type::has_operator_string{},
+                                       " ", test_type::convertible_to_int{}));
+    }
+
+    SECTION("the result is allocated once")
+    {
+        std::string const long_text(100, 'l');
+        auto const result = bosswestfalen::concat(long_text, 12345, long_text);
+        CHECK(result.size() == result.capacity());
+    }
+}
+
+SCENARIO("adding several values at once")
+{
+    GIVEN("a string_builder")
+    {
+        bosswestfalen::string_builder sb;
+
+        WHEN("several values are added at once")
+        {
+            sb.add("a");
+            sb.add("user=", 42, " ", test_type::has_sb_append{7});
+            sb.add(3, "z");
+
+            THEN("the result is the concatenation of all values")
+            {
+                CHECK(std::string{"auser=42 sb_append:73z"} == sb.build());
+            }
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string_builder.hpp>
+
+
+SCENARIO("concurrent string builder")
+{
+    GIVEN("an empty concurrent_string_builder")
+    {
+        bosswestfalen::concurrent_string_builder sb;
+
+        WHEN("its result is requested")
+        {
+            THEN("it is an empty string")
+            {
+                CHECK(std::string{} == sb.build());
+                CHECK(0 == sb.size());
+            }
+        }
+
+        WHEN("a single thread adds values")
+        {
+            sb.add("cat");
+            sb.add(1, "dog");
+            sb.add_view("fish");
+
+            THEN("the result contains them in order")
+            {
+                CHECK(std::string{"cat1dogfish"} == sb.build());
+            }
+        }
+
+        WHEN("many threads add values at the same time")
+        {
+            constexpr int thread_count{8};
+            constexpr int values_per_thread{20000};
+
+            std::vector<std::thread> threads;
+            for (int t{0}; t < thread_count; ++t)
+            {
+                threads.emplace_back([&sb, t]
+                {
+                    for (int i{0}; i < values_per_thread; ++i)
+                    {
+                        sb.add(t, ":", i, ";");
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            THEN("all values are contained and each thread's values are in order")
+            {
+                auto const result = sb.build(4, 0);
+                CHECK(result.size() == sb.size());
+
+                std::vector<int> next(thread_count, 0);
+                auto previous_thread = -1;
+                auto blocks = 0;
+                std::istringstream stream{result};
+                int t{0};
+                int i{0};
+                char colon{};
+                char semicolon{};
+                while (stream >> t >> colon >> i >> semicolon)
+                {
+                    REQUIRE(t >= 0);
+                    REQUIRE(t < thread_count);
+                    CHECK(next[static_cast<std::size_t>(t)] == i);
+                    next[static_cast<std::size_t>(t)] = i + 1;
+                    if (t != previous_thread)
+                    {
+                        ++blocks;
+                        previous_thread = t;
+                    }
+                }
+                for (auto const count : next)
+                {
+                    CHECK(values_per_thread == count);
+                }
+                CHECK(thread_count == blocks);
+            }
+        }
+
+        WHEN("the size is read while threads add values")
+        {
+            constexpr int thread_count{4};
+            constexpr int values_per_thread{10000};
+
+            std::vector<std::thread> threads;
+            for (int t{0}; t < thread_count; ++t)
+            {
+                threads.emplace_back([&sb]
+                {
+                    for (int i{0}; i < values_per_thread; ++i)
+                    {
+                        sb.add("ab");
+                    }
+                });
+            }
+            std::string::size_type previous{0};
+            auto grows = true;
+            for (int i{0}; i < 1000; ++i)
+            {
+                auto const current = sb.size();
+                grows = grows and current >= previous;
+                previous = current;
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            THEN("it never decreases and reaches the size of the result")
+            {
+                CHECK(grows);
+                CHECK(sb.size() == std::string::size_type{2 * thread_count * values_per_thread});
+                CHECK(sb.build().size() == sb.size());
+            }
+        }
+    }
+
+    GIVEN("more builders than a thread caches")
+    {
+        std::vector<std::unique_ptr<bosswestfalen::concurrent_string_builder>> builders;
+        for (int b{0}; b < 20; ++b)
+        {
+            builders.push_back(std::make_unique<bosswestfalen::concurrent_string_builder>());
+        }
+
+        WHEN("a thread adds to all of them alternately")
+        {
+            for (int i{0}; i < 3; ++i)
+            {
+                for (auto& builder : builders)
+                {
+                    builder->add(i);
+                }
+            }
+
+            THEN("each builder keeps a single segment in order")
+            {
+                for (auto const& builder : builders)
+                {
+                    CHECK(std::string{"012"} == builder->build());
+                }
+            }
+        }
+    }
+}
@@ -48,7 +48,7 @@ TEST_CASE("conversion")
         CHECK(result_i == bosswestfalen::make_string(10));
 
         double d{10.0};
-        auto const result_d{std::to_string(d)};
+        std::string const result_d{"10"};
         CHECK(result_d == bosswestfalen::make_string(d));
         CHECK(result_d == bosswestfalen::make_string(std::as_const(d)));
         CHECK(result_d == bosswestfalen::make_string(10.0));
@@ -73,3 +73,54 @@ TEST_CASE("conversion")
     }
 }
 
+
+
+namespace
+{
+
+struct not_convertible final
+{
+};
+
+/// The checks of `append_to` give the same results as the class templates in `type_traits`.
+template <typename T>
+constexpr bool same_checks()
+{
+    using namespace bosswestfalen::type_traits;
+    return is_builtin_type_v<T> == is_builtin_type<T>::value
+        and is_automatically_convertible_v<T> == is_automatically_convertible<T>::value
+        and has_external_to_string_v<T> == has_external_to_string<T>::value
+        and has_stream_operator_v<T> == has_stream_operator<T>::value
+        and has_sb_append_v<T> == has_sb_append<T>::value;
+}
+
+}
+
+
+TEST_CASE("conversion checks")
+{
+    static_assert(same_checks<int>());
+    static_assert(same_checks<double const&>());
+    static_assert(same_checks<std::string>());
+    static_assert(same_checks<char const(&)[4]>());
+    static_assert(same_checks<char const*>());
+    static_assert(same_checks<test_type::has_operator_string>());
+    static_assert(same_checks<test_type::has_explicit_operator_string>());
+    static_assert(same_checks<test_type::has_external_to_string>());
+    static_assert(same_checks<test_type::has_operator_ll const&>());
+    static_assert(same_checks<test_type::convertible_to_int>());
+    static_assert(same_checks<test_type::has_sb_append>());
+    static_assert(same_checks<test_type::has_sb_append_and_to_string>());
+    static_assert(same_checks<not_convertible>());
+
+    static_assert(not bosswestfalen::type_traits::has_sb_append_v<not_convertible>);
+    static_assert(not bosswestfalen::type_traits::has_external_to_string_v<not_convertible>);
+    static_assert(not bosswestfalen::type_traits::has_stream_operator_v<not_convertible>);
+
+#ifdef BOSSWESTFALEN_SB_CONCEPTS
+    static_assert(bosswestfalen::type_traits::appendable<test_type::has_operator_ll>);
+    static_assert(not bosswestfalen::type_traits::appendable<not_convertible>);
+#endif
+
+    CHECK(std::string{"sb_append"} == bosswestfalen::make_string(test_type::has_sb_append_and_to_string{}));
+}
@@ -0,0 +1,236 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+/// Byte-by-byte reference for `escape_mode::json`.
+std::string json_reference(std::string_view const text)
+{
+    std::string result;
+    for (auto const character : text)
+    {
+        switch (character)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\b':
+                result += "\\b";
+                break;
+            case '\f':
+                result += "\\f";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\r':
+                result += "\\r";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(character));
+                    result += buffer;
+                }
+                else
+                {
+                    result += character;
+                }
+        }
+    }
+    return result;
+}
+
+/// Byte-by-byte reference for `escape_mode::html`.
+std::string html_reference(std::string_view const text)
+{
+    std::string result;
+    for (auto const character : text)
+    {
+        switch (character)
+        {
+            case '&':
+                result += "&amp;";
+                break;
+            case '<':
+                result += "&lt;";
+                break;
+            case '>':
+                result += "&gt;";
+                break;
+            case '"':
+                result += "&quot;";
+                break;
+            case '\'':
+                result += "&#39;";
+                break;
+            default:
+                result += character;
+        }
+    }
+    return result;
+}
+
+/// Byte-by-byte reference for `escape_mode::csv`.
+std::string csv_reference(std::string_view const text)
+{
+    if (text.find_first_of("\",\r\n") == std::string_view::npos)
+    {
+        return std::string{text};
+    }
+    std::string result{"\""};
+    for (auto const character : text)
+    {
+        if (character == '"')
+        {
+            result += '"';
+        }
+        result += character;
+    }
+    return result + '"';
+}
+
+/// Byte-by-byte reference for `escape_mode::shell`.
+std::string shell_reference(std::string_view const text)
+{
+    std::string result{"'"};
+    for (auto const character : text)
+    {
+        if (character == '\'')
+        {
+            result += "'\\''";
+        }
+        else
+        {
+            result += character;
+        }
+    }
+    return result + "'";
+}
+
+/// Random text of up to 200 characters, mostly letters with some characters that need escaping.
+std::string random_text(std::mt19937& random)
+{
+    static constexpr char special[]{'"', '\\', '&', '<', '>', '\'', ',', '\r', '\n', '\t', '\0', '\x1f', '\x7f', '\x80', '\xff'};
+    auto const size = std::uniform_int_distribution<std::size_t>{0, 200}(random);
+    auto const density = std::uniform_int_distribution<int>{0, 50}(random);
+    std::string text;
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        if (std::uniform_int_distribution<int>{0, 99}(random) < density)
+        {
+            text += special[std::uniform_int_distribution<std::size_t>{0, sizeof(special) - 1}(random)];
+        }
+        else
+        {
+            text += static_cast<char>(std::uniform_int_distribution<int>{-128, 127}(random));
+        }
+    }
+    return text;
+}
+
+}
+
+
+TEST_CASE("escaping")
+{
+    using bosswestfalen::make_string;
+
+    SECTION("json")
+    {
+        CHECK(make_string(bosswestfalen::json_escaped("plain")) == "plain");
+        CHECK(make_string(bosswestfalen::json_escaped("say \"hi\"\\\n")) == "say \\\"hi\\\"\\\\\\n");
+        CHECK(make_string(bosswestfalen::json_escaped(std::string{"\0\x01\x1f\x7f", 4})) == "\\u0000\\u0001\\u001f\x7f");
+        CHECK(make_string(bosswestfalen::json_escaped("\xc3\xa4")) == "\xc3\xa4");
+    }
+
+    SECTION("html")
+    {
+        CHECK(make_string(bosswestfalen::html_escaped("<a href=\"x\">Tom & 'Jerry'</a>"))
+              == "&lt;a href=&quot;x&quot;&gt;Tom &amp; &#39;Jerry&#39;&lt;/a&gt;");
+    }
+
+    SECTION("csv")
+    {
+        CHECK(make_string(bosswestfalen::csv_escaped("plain text")) == "plain text");
+        CHECK(make_string(bosswestfalen::csv_escaped("a,b")) == "\"a,b\"");
+        CHECK(make_string(bosswestfalen::csv_escaped("say \"hi\"")) == "\"say \"\"hi\"\"\"");
+        CHECK(make_string(bosswestfalen::csv_escaped("line\r\n")) == "\"line\r\n\"");
+        CHECK(make_string(bosswestfalen::csv_escaped("")).empty());
+    }
+
+    SECTION("shell")
+    {
+        CHECK(make_string(bosswestfalen::shell_escaped("")) == "''");
+        CHECK(make_string(bosswestfalen::shell_escaped("$HOME; rm -rf *")) == "'$HOME; rm -rf *'");
+        CHECK(make_string(bosswestfalen::shell_escaped("it's")) == "'it'\\''s'");
+    }
+
+    SECTION("values that are not strings")
+    {
+        CHECK(make_string(bosswestfalen::html_escaped(42)) == "42");
+        CHECK(make_string(bosswestfalen::json_escaped(test_type::has_operator_ll{})) == "stream");
+        CHECK(make_string(bosswestfalen::shell_escaped(test_type::has_sb_append{7})) == "'sb_append:7'");
+        std::string const large(1000, '<');
+        CHECK(make_string(bosswestfalen::csv_escaped(bosswestfalen::join(std::vector<std::string>{large, large}, ",")))
+              == '"' + large + ',' + large + '"');
+    }
+
+    SECTION("in concat and builders")
+    {
+        CHECK(bosswestfalen::concat("{\"name\":\"", bosswestfalen::json_escaped("a\"b"), "\"}") == "{\"name\":\"a\\\"b\"}");
+
+        bosswestfalen::string_builder sb;
+        sb.add("<p>");
+        sb.add(bosswestfalen::html_escaped(std::string{"1 < 2"}));
+        sb.prepend(bosswestfalen::shell_escaped("echo"));
+        sb.add("</p>");
+        CHECK(sb.size() == 21);
+        CHECK(sb.build() == "'echo'<p>1 &lt; 2</p>");
+    }
+}
+
+
+TEST_CASE("escaping matches a byte-by-byte reference")
+{
+    using bosswestfalen::make_string;
+    using bosswestfalen::escape_mode;
+    using namespace bosswestfalen::detail;
+
+    std::mt19937 random{2018};
+    for (int i{0}; i < 2000; ++i)
+    {
+        auto const text = random_text(random);
+        INFO("text: " << json_reference(text));
+
+        CHECK(make_string(bosswestfalen::json_escaped(text)) == json_reference(text));
+        CHECK(make_string(bosswestfalen::html_escaped(text)) == html_reference(text));
+        CHECK(make_string(bosswestfalen::csv_escaped(text)) == csv_reference(text));
+        CHECK(make_string(bosswestfalen::shell_escaped(text)) == shell_reference(text));
+
+        CHECK(escaped_size<escape_mode::json>(text) == json_reference(text).size());
+        CHECK(escaped_size<escape_mode::html>(text) == html_reference(text).size());
+        CHECK(escaped_size<escape_mode::csv>(text) == csv_reference(text).size());
+        CHECK(escaped_size<escape_mode::shell>(text) == shell_reference(text).size());
+
+        CHECK(find_escape<escape_mode::json>(text) == find_escape_scalar<escape_mode::json>(text));
+        CHECK(find_escape<escape_mode::html>(text) == find_escape_scalar<escape_mode::html>(text));
+        CHECK(find_escape<escape_mode::csv>(text) == find_escape_scalar<escape_mode::csv>(text));
+        CHECK(find_escape<escape_mode::shell>(text) == find_escape_scalar<escape_mode::shell>(text));
+    }
+}
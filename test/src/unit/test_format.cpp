@@ -0,0 +1,100 @@
+#include <catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+constexpr char message[]{"user={} action={} ms={}"};
+constexpr char no_placeholder[]{"plain text"};
+constexpr char only_placeholders[]{"{}{}"};
+constexpr char braces[]{"{{{}}} {{}}"};
+
+
+/// Claims to write `size` characters; only measured, never written (the result is too large).
+struct claims_size final
+{
+    std::size_t size;
+};
+
+void sb_append(bosswestfalen::sink& out, claims_size const& x)
+{
+    static char const text[]{"x"};
+    out.append(text, x.size);
+}
+
+}
+
+
+TEST_CASE("format")
+{
+    using bosswestfalen::format;
+
+    SECTION("values of all kinds")
+    {
+        CHECK(format<message>(12345, std::string{"login"}, 1.5) == "user=12345 action=login ms=1.5");
+        CHECK(format<message>("a", test_type::has_sb_append{1}, test_type::has_operator_ll{}) == "user=a action=sb_append:1 ms=stream");
+        CHECK(format<message>(bosswestfalen::width(7, 3, '0'), bosswestfalen::json_escaped("\"x\""), std::string_view{})
+              == "user=007 action=\\\"x\\\" ms=");
+    }
+
+    SECTION("patterns without literals or placeholders")
+    {
+        CHECK(format<no_placeholder>() == "plain text");
+        CHECK(format<only_placeholders>(1, 2) == "12");
+        CHECK(format<only_placeholders>("", "").empty());
+    }
+
+    SECTION("escaped braces")
+    {
+        CHECK(format<braces>(42) == "{42} {}");
+    }
+
+    SECTION("local pattern")
+    {
+        static constexpr char pattern[]{"[{}]"};
+        CHECK(format<pattern>(std::string(1000, 'x')) == "[" + std::string(1000, 'x') + "]");
+    }
+
+    SECTION("result too large")
+    {
+        // the literal characters alone push the result over the limit
+        auto const max_size = std::string{}.max_size();
+        CHECK_THROWS_AS(format<message>(claims_size{max_size - 17}, 1, 2), std::length_error);
+        CHECK_THROWS_AS(format<message>(claims_size{max_size}, "", ""), std::length_error);
+        CHECK_THROWS_AS(format<only_placeholders>(claims_size{max_size}, claims_size{max_size}), std::length_error);
+    }
+
+#ifdef BOSSWESTFALEN_SB_FIXED_STRING
+    SECTION("string literal as pattern")
+    {
+        CHECK(format<"user={} ms={}">(1, 2) == "user=1 ms=2");
+        CHECK(format<message>(1, 2, 3) == "user=1 action=2 ms=3");
+    }
+#endif
+}
+
+
+TEST_CASE("format pattern is parsed at compile time")
+{
+    using bosswestfalen::detail::parse_format;
+
+    constexpr auto layout = parse_format(message);
+    static_assert(layout.placeholders == 3);
+    static_assert(layout.size == 17);
+    static_assert(layout.valid);
+    static_assert(layout.piece(0) == "user=");
+    static_assert(layout.piece(1) == " action=");
+    static_assert(layout.piece(3).empty());
+
+    static_assert(parse_format(braces).piece(0) == "{");
+    static_assert(parse_format(braces).piece(1) == "} {}");
+    static_assert(not parse_format("a{b").valid);
+    static_assert(not parse_format("a}").valid);
+    static_assert(not parse_format("{").valid);
+    CHECK(layout.valid);
+}
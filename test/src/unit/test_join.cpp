@@ -0,0 +1,138 @@
+#include <catch.hpp>
+#include <array>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+TEST_CASE("join")
+{
+    using bosswestfalen::join;
+    using bosswestfalen::make_string;
+
+    SECTION("empty range")
+    {
+        CHECK(make_string(join(std::vector<int>{}, ", ")).empty());
+        CHECK(make_string(join(std::vector<int>{}, ", ", "[", "]")) == "[]");
+    }
+
+    SECTION("single element")
+    {
+        CHECK(make_string(join(std::vector<int>{1}, ", ", "[", "]")) == "[1]");
+    }
+
+    SECTION("strings")
+    {
+        std::vector<std::string> const tags{"red", "green", "blue"};
+        CHECK(make_string(join(tags, ",")) == "red,green,blue");
+        CHECK(make_string(join(tags, "", "<", ">")) == "<redgreenblue>");
+    }
+
+    SECTION("arrays and lists")
+    {
+        int const numbers[]{1, 2, 3};
+        CHECK(make_string(join(numbers, " ")) == "1 2 3");
+        CHECK(make_string(join(std::list<double>{0.5, 1.5}, ";")) == "0.5;1.5");
+        CHECK(make_string(join(std::array<char const*, 2>{"a", "b"}, "|")) == "a|b");
+    }
+
+    SECTION("elements with custom conversions")
+    {
+        std::vector<test_type::has_sb_append> const hooks{{1}, {2}};
+        CHECK(make_string(join(hooks, " ")) == "sb_append:1 sb_append:2");
+        std::vector<test_type::has_operator_ll> const streamed(2);
+        CHECK(make_string(join(streamed, "+")) == "stream+stream");
+        std::vector<test_type::has_external_to_string> const converted(2);
+        CHECK(make_string(join(converted, "+")) == "external_to_string+external_to_string");
+    }
+
+    SECTION("pairs")
+    {
+        std::map<std::string, int> const counts{{"a", 1}, {"b", 2}};
+        CHECK(make_string(join(counts, "&")) == "a=1&b=2");
+        CHECK(make_string(join(std::vector<std::pair<int, std::string>>{{1, "x"}}, ",")) == "1=x");
+    }
+
+    SECTION("nested ranges")
+    {
+        std::vector<std::vector<int>> const matrix{{1, 2}, {}, {3}};
+        CHECK(make_string(join(matrix, ", ", "[", "]")) == "[[1, 2], [], [3]]");
+        std::map<std::string, std::vector<int>> const lists{{"x", {1, 2}}, {"y", {}}};
+        CHECK(make_string(join(lists, ";", "(", ")")) == "(x=(1;2);y=())");
+    }
+
+    SECTION("in concat")
+    {
+        CHECK(bosswestfalen::concat("tags: ", join(std::vector<int>{1, 2}, ","), "!") == "tags: 1,2!");
+    }
+}
+
+
+SCENARIO("add_range")
+{
+    GIVEN("a string_builder")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("row: ");
+
+        WHEN("a range of strings is added")
+        {
+            std::vector<std::string> const cells{"a", "bb", "", "ccc"};
+            sb.add_range(cells, ",", "{", "}");
+
+            THEN("it is stored as a single fragment")
+            {
+                CHECK(sb.build() == "row: {a,bb,,ccc}");
+                CHECK(sb.size() == 16);
+
+                bosswestfalen::instrumented_string_builder single;
+                bosswestfalen::reset_statistics();
+                single.add_range(cells, ",");
+                CHECK(bosswestfalen::thread_statistics().fragments == 1);
+                CHECK(bosswestfalen::thread_statistics().fragment_bytes == 9);
+            }
+        }
+
+        WHEN("a range of numbers is added")
+        {
+            sb.add_range(std::deque<int>{1, 22, 333}, ", ");
+
+            THEN("the numbers are separated")
+            {
+                CHECK(sb.build() == "row: 1, 22, 333");
+                CHECK(sb.size() == 15);
+            }
+        }
+
+        WHEN("an empty range is added")
+        {
+            sb.add_range(std::vector<std::string>{}, ",");
+
+            THEN("nothing changes")
+            {
+                CHECK(sb.build() == "row: ");
+            }
+        }
+    }
+
+    GIVEN("a string_builder with std::deque as storage")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+
+        WHEN("a map is added")
+        {
+            sb.add_range(std::map<int, char const*>{{1, "one"}, {2, "two"}}, "\n");
+
+            THEN("keys and values are written")
+            {
+                CHECK(sb.build() == "1=one\n2=two");
+            }
+        }
+    }
+}
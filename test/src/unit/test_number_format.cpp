@@ -0,0 +1,177 @@
+#include <catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+template <typename T>
+std::string printf_string(char const* format, T const value)
+{
+    char buffer[512];
+    auto const length = std::snprintf(buffer, sizeof(buffer), format, value);
+    return std::string(buffer, static_cast<std::size_t>(length));
+}
+
+}
+
+
+TEST_CASE("integers")
+{
+    using bosswestfalen::make_string;
+
+    SECTION("limits")
+    {
+        CHECK(make_string(std::numeric_limits<std::int64_t>::min()) == std::to_string(std::numeric_limits<std::int64_t>::min()));
+        CHECK(make_string(std::numeric_limits<std::int64_t>::max()) == std::to_string(std::numeric_limits<std::int64_t>::max()));
+        CHECK(make_string(std::numeric_limits<std::uint64_t>::max()) == std::to_string(std::numeric_limits<std::uint64_t>::max()));
+        CHECK(make_string(std::numeric_limits<std::int8_t>::min()) == "-128");
+        CHECK(make_string(std::uint16_t{65535}) == "65535");
+    }
+
+    SECTION("every number of digits")
+    {
+        std::uint64_t value{1};
+        for (int digits{1}; digits <= 19; ++digits)
+        {
+            CHECK(make_string(value) == std::to_string(value));
+            CHECK(make_string(value - 1) == std::to_string(value - 1));
+            CHECK(make_string(-static_cast<std::int64_t>(value)) == std::to_string(-static_cast<std::int64_t>(value)));
+            value *= 10;
+        }
+    }
+
+    SECTION("random values")
+    {
+        std::mt19937_64 random{42};
+        for (int i{0}; i < 10000; ++i)
+        {
+            auto const value = static_cast<std::int64_t>(random()) >> (i % 64);
+            CHECK(make_string(value) == std::to_string(value));
+        }
+    }
+
+    SECTION("usable in constant expressions")
+    {
+        constexpr auto first = []
+        {
+            char buffer[16]{};
+            return bosswestfalen::detail::format_decimal(buffer, -1234);
+        }();
+        CHECK(first == 11);
+    }
+}
+
+
+TEST_CASE("floating point values")
+{
+    using bosswestfalen::make_string;
+
+    SECTION("shortest round-trip form")
+    {
+        CHECK(make_string(0.0) == "0");
+        CHECK(make_string(-0.0) == "-0");
+        CHECK(make_string(0.1) == "0.1");
+        CHECK(make_string(1.0 / 3.0) == "0.3333333333333333");
+        CHECK(make_string(0.1f) == "0.1");
+        CHECK(make_string(123456789.0) == "123456789");
+        CHECK(make_string(1e-7) == "1e-07");
+        CHECK(make_string(std::numeric_limits<double>::infinity()) == "inf");
+        CHECK(make_string(-std::numeric_limits<double>::infinity()) == "-inf");
+        CHECK(make_string(std::numeric_limits<double>::quiet_NaN()) == "nan");
+    }
+
+    SECTION("values read back unchanged")
+    {
+        std::mt19937_64 random{7};
+        for (int i{0}; i < 10000; ++i)
+        {
+            auto value = 0.0;
+            auto const bits = random();
+            std::memcpy(&value, &bits, sizeof(value));
+            if (std::isfinite(value))
+            {
+                CHECK(std::strtod(make_string(value).c_str(), nullptr) == value);
+            }
+        }
+    }
+}
+
+
+TEST_CASE("format tags")
+{
+    using bosswestfalen::make_string;
+
+    SECTION("fixed")
+    {
+        CHECK(make_string(bosswestfalen::fixed(3.14159, 3)) == "3.142");
+        CHECK(make_string(bosswestfalen::fixed(2.5)) == "2.500000");
+        CHECK(make_string(bosswestfalen::fixed(-1.0f, 0)) == "-1");
+        CHECK(make_string(bosswestfalen::fixed(1e300, 2)) == printf_string("%.2f", 1e300));
+        CHECK(make_string(bosswestfalen::fixed(1.25L, 1)) == printf_string("%.1Lf", 1.25L));
+    }
+
+    SECTION("scientific")
+    {
+        CHECK(make_string(bosswestfalen::scientific(1234.5)) == "1.2345e+03");
+        CHECK(make_string(bosswestfalen::scientific(1234.5, 2)) == "1.23e+03");
+    }
+
+    SECTION("precision")
+    {
+        CHECK(make_string(bosswestfalen::precision(1234.5678, 6)) == printf_string("%.6g", 1234.5678));
+        CHECK(make_string(bosswestfalen::precision(0.000012345, 2)) == printf_string("%.2g", 0.000012345));
+    }
+
+    SECTION("hex")
+    {
+        CHECK(make_string(bosswestfalen::hex(255)) == "ff");
+        CHECK(make_string(bosswestfalen::hex(-26)) == "-1a");
+        CHECK(make_string(bosswestfalen::hex(std::uint64_t{0xdeadbeefcafe})) == "deadbeefcafe");
+        CHECK(make_string(bosswestfalen::hex(3.0)) == "1.8p+1");
+    }
+
+    SECTION("width")
+    {
+        CHECK(make_string(bosswestfalen::width(42, 5, '0')) == "00042");
+        CHECK(make_string(bosswestfalen::width(42, 1)) == "42");
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::fixed(1.5, 2), 8)) == "    1.50");
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::hex(255u), 4, '0')) == "00ff");
+    }
+
+    SECTION("width of negative numbers")
+    {
+        CHECK(make_string(bosswestfalen::width(-42, 5, '0')) == printf_string("%05d", -42));
+        CHECK(make_string(bosswestfalen::width(-42, 5)) == printf_string("%5d", -42));
+        CHECK(make_string(bosswestfalen::width(-42, 2, '0')) == "-42");
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::hex(-26), 5, '0')) == "-001a");
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::fixed(-1.5, 2), 7, '0')) == printf_string("%07.2f", -1.5));
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::fixed(-1.5, 2), 7)) == printf_string("%7.2f", -1.5));
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::scientific(-1234.5, 2), 11, '0')) == printf_string("%011.2e", -1234.5));
+        CHECK(make_string(bosswestfalen::width(bosswestfalen::scientific(-1234.5, 2), 11)) == printf_string("%11.2e", -1234.5));
+        CHECK(make_string(bosswestfalen::width(-std::numeric_limits<double>::infinity(), 6, '0')) == "  -inf");
+    }
+
+    SECTION("output longer than the stack buffer")
+    {
+        CHECK(make_string(bosswestfalen::fixed(1e300, 200)) == printf_string("%.200f", 1e300));
+        CHECK(make_string(bosswestfalen::width(1, 1000, '.')) == std::string(999, '.') + "1");
+    }
+
+    SECTION("in a builder")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add(bosswestfalen::fixed(0.125, 2));
+        sb.add("|");
+        sb.add(bosswestfalen::hex(10), bosswestfalen::width(7, 3, '0'), 0.5);
+        CHECK(sb.build() == "0.12|a0070.5");
+    }
+}
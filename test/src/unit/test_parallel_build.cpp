@@ -0,0 +1,84 @@
+#include <catch.hpp>
+#include <deque>
+#include <string>
+#include <string_builder.hpp>
+
+
+SCENARIO("parallel build")
+{
+    GIVEN("an empty string_builder")
+    {
+        bosswestfalen::string_builder sb;
+
+        WHEN("its result is built in parallel")
+        {
+            THEN("it is an empty string")
+            {
+                CHECK(std::string{} == sb.build_parallel(4, 0));
+            }
+        }
+    }
+
+    GIVEN("a string_builder with many fragments")
+    {
+        bosswestfalen::string_builder sb;
+        for (int i{0}; i < 20000; ++i)
+        {
+            sb.add(i);
+            sb.add(" ");
+        }
+        auto const expected = sb.build();
+
+        WHEN("the result is built with different numbers of threads")
+        {
+            THEN("the result is the same as with build()")
+            {
+                for (unsigned threads{1}; threads <= 9; ++threads)
+                {
+                    CHECK(expected == sb.build_parallel(threads, 0));
+                }
+            }
+        }
+
+        WHEN("the result is smaller than the threshold")
+        {
+            THEN("the result is built serially")
+            {
+                CHECK(expected == sb.build_parallel(4, expected.size() + 1));
+            }
+        }
+    }
+
+    GIVEN("a string_builder using std::deque with less characters than threads")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        sb.add("a");
+        sb.add("");
+        sb.add("b");
+
+        WHEN("the result is built in parallel")
+        {
+            THEN("the result is the same as with build()")
+            {
+                CHECK(std::string{"ab"} == sb.build_parallel(8, 0));
+            }
+        }
+    }
+
+    GIVEN("a string_builder with a single large fragment")
+    {
+        bosswestfalen::string_builder sb;
+        std::string large(1000000, 'x');
+        large[0] = 'a';
+        large.back() = 'z';
+        sb.add(large);
+
+        WHEN("the result is built in parallel")
+        {
+            THEN("the fragment is split between the threads")
+            {
+                CHECK(large == sb.build_parallel(3, 0));
+            }
+        }
+    }
+}
@@ -0,0 +1,245 @@
+#include <catch.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+/// Number of calls of the global `operator new`.
+std::atomic<std::size_t> global_allocations{0};
+
+/// `memory_resource` counting the allocations passed to `upstream`.
+class counting_resource final : public std::pmr::memory_resource
+{
+  public:
+    explicit counting_resource(std::pmr::memory_resource* const upstream = std::pmr::new_delete_resource())
+        : upstream{upstream}
+    {
+    }
+
+    std::size_t allocations{0};
+    std::size_t deallocations{0};
+    std::size_t bytes{0};
+
+  private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(std::size_t const size, std::size_t const alignment) override
+    {
+        auto const memory = upstream->allocate(size, alignment);
+        ++allocations;
+        bytes += size;
+        return memory;
+    }
+
+    void do_deallocate(void* const memory, std::size_t const size, std::size_t const alignment) override
+    {
+        ++deallocations;
+        upstream->deallocate(memory, size, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/// Counts the calls of the global `operator new` while it exists.
+class global_allocation_counter final
+{
+  public:
+    global_allocation_counter() noexcept
+        : start{global_allocations.load()}
+    {
+    }
+
+    std::size_t count() const noexcept
+    {
+        return global_allocations.load() - start;
+    }
+
+  private:
+    std::size_t start;
+};
+
+}
+
+// AddressSanitizer replaces operator new itself, no counting then
+#ifndef __SANITIZE_ADDRESS__
+
+void* operator new(std::size_t const size)
+{
+    ++global_allocations;
+    if (auto const memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* const memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+#endif
+
+
+SCENARIO("pmr::string_builder")
+{
+    GIVEN("a builder using a counting resource")
+    {
+        counting_resource resource;
+        std::string const large(5000, 'x');
+        auto const expected = "literal 42 view " + large + " 1.5sb_append:42";
+        std::size_t global{0};
+        bool same_content{false};
+        bool same_resource{false};
+        {
+            global_allocation_counter const counter;
+            bosswestfalen::pmr::string_builder sb{&resource};
+            sb.add("literal ");
+            sb.add(42);
+            sb.add(std::string_view{" view "});
+            sb.add(std::string_view{large});
+            sb.add(" ", 1.5, test_type::has_sb_append{});
+            auto const result = sb.build();
+            global = counter.count();
+            same_content = std::string_view{result} == expected;
+            same_resource = result.get_allocator().resource() == &resource;
+        }
+
+        THEN("all memory comes from the resource")
+        {
+            CHECK(global == 0);
+            CHECK(same_content);
+            CHECK(same_resource);
+            CHECK(resource.allocations > 0);
+            CHECK(resource.allocations == resource.deallocations);
+        }
+    }
+
+    GIVEN("a builder using a monotonic buffer without upstream")
+    {
+        alignas(std::max_align_t) char buffer[64 * 1024];
+        std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+        bosswestfalen::pmr::string_builder sb{&arena};
+
+        WHEN("values are added and the result is built")
+        {
+            global_allocation_counter const counter;
+            for (int i{0}; i < 100; ++i)
+            {
+                sb.add(i, ",");
+            }
+            auto const& cached = sb.build_cached();
+            auto const taken = sb.take();
+            auto const count = counter.count();
+
+            THEN("the arena is used")
+            {
+                CHECK(count == 0);
+                CHECK(cached.empty());
+                CHECK(taken.size() == 290);
+                CHECK(taken.substr(0, 8) == "0,1,2,3,");
+                CHECK(taken.get_allocator().resource() == &arena);
+            }
+        }
+    }
+
+    GIVEN("a builder with a std::pmr::deque")
+    {
+        counting_resource resource;
+        std::string const large(100, 'x');
+        std::size_t global{0};
+        bool same_content{false};
+        {
+            global_allocation_counter const counter;
+            bosswestfalen::pmr::basic_string_builder<std::pmr::deque> sb{&resource};
+            sb.add("cat");
+            sb.add(std::string_view{large});
+            sb.add_view("dog");
+            auto const result = sb.build();
+            global = counter.count();
+            same_content = std::string_view{result} == "cat" + large + "dog";
+        }
+
+        THEN("the deque and all fragments use the resource")
+        {
+            CHECK(global == 0);
+            CHECK(same_content);
+            CHECK(resource.allocations > 0);
+            CHECK(resource.allocations == resource.deallocations);
+        }
+    }
+
+    GIVEN("two builders with different resources")
+    {
+        counting_resource first_resource;
+        counting_resource second_resource;
+        bosswestfalen::pmr::string_builder first{&first_resource};
+        bosswestfalen::pmr::string_builder second{&second_resource};
+        first.add(std::string(100, 'a'));
+        second.add(std::string(100, 'b'));
+
+        WHEN("one is moved to the other")
+        {
+            first = std::move(second);
+
+            THEN("the content is copied, the resource is kept")
+            {
+                CHECK(first.build() == std::pmr::string(100, 'b'));
+                CHECK(first.get_allocator().resource() == &first_resource);
+            }
+        }
+
+        WHEN("one is copied to the other")
+        {
+            first = second;
+
+            THEN("the content is copied, the resource is kept")
+            {
+                CHECK(first.build() == std::pmr::string(100, 'b'));
+                CHECK(second.build() == std::pmr::string(100, 'b'));
+                CHECK(first.get_allocator().resource() == &first_resource);
+            }
+        }
+    }
+}
+
+
+TEST_CASE("chunked_storage with an allocator")
+{
+    counting_resource resource;
+    using storage_type = bosswestfalen::chunked_storage<std::pmr::string>;
+
+    {
+        storage_type storage{&resource};
+        CHECK(resource.allocations == 0);
+        storage.append([](bosswestfalen::sink& out)
+        {
+            out.append("cat");
+        });
+        CHECK(resource.allocations == 3);
+
+        storage_type copy{storage};
+        CHECK(copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+        storage.clear();
+        CHECK(resource.deallocations == 3);
+        CHECK(storage.get_allocator().resource() == &resource);
+    }
+    CHECK(resource.allocations == resource.deallocations);
+}
@@ -0,0 +1,178 @@
+#include <catch.hpp>
+#include <deque>
+#include <list>
+#include <random>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+/// Add `text` to `sb` in random pieces (some empty, some as views, some prepended).
+template <typename Builder>
+void add_in_pieces(Builder& sb, std::string const& text, std::mt19937& random)
+{
+    // appended pieces grow to the right, prepended pieces to the left of a random point
+    auto left = std::uniform_int_distribution<std::size_t>{0, text.size()}(random);
+    auto right = left;
+    while (left > 0 or right < text.size())
+    {
+        auto const kind = std::uniform_int_distribution<int>{0, 2}(random);
+        if (kind == 2 and left > 0)
+        {
+            auto const size = std::uniform_int_distribution<std::size_t>{0, std::min<std::size_t>(left, 8)}(random);
+            sb.prepend(text.substr(left - size, size));
+            left -= size;
+            continue;
+        }
+        auto const size = std::uniform_int_distribution<std::size_t>{0, std::min<std::size_t>(text.size() - right, 8)}(random);
+        if (kind == 0)
+        {
+            sb.add(text.substr(right, size));
+        }
+        else
+        {
+            sb.add_view(std::string_view{text}.substr(right, size));
+        }
+        right += size;
+    }
+}
+
+/// Random text of up to 60 characters from a small alphabet, so that searches find something.
+std::string random_text(std::mt19937& random)
+{
+    auto const size = std::uniform_int_distribution<std::size_t>{0, 60}(random);
+    std::string text;
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        text += static_cast<char>('a' + std::uniform_int_distribution<int>{0, 2}(random));
+    }
+    return text;
+}
+
+/// -1, 0, or 1 for the sign of `value`.
+int sign(int const value)
+{
+    return (value > 0) - (value < 0);
+}
+
+}
+
+
+SCENARIO("segments of a builder")
+{
+    GIVEN("a builder with stored and prepended strings")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("world");
+        sb.add("");
+        sb.prepend("hello ");
+        sb.add("!");
+
+        WHEN("its segments are concatenated")
+        {
+            std::string concatenated;
+            for (auto const segment : sb.segments())
+            {
+                concatenated += segment;
+            }
+
+            THEN("the result equals build()")
+            {
+                CHECK(concatenated == sb.build());
+            }
+        }
+
+        THEN("the algorithms work without building")
+        {
+            CHECK(sb.hash() == bosswestfalen::fnv1a("hello world!"));
+            CHECK(sb.equals("hello world!"));
+            CHECK_FALSE(sb.equals("hello world"));
+            CHECK(sb.starts_with("hello w"));
+            CHECK_FALSE(sb.starts_with("hello!"));
+            CHECK(sb.find("o w") == 4);
+            CHECK(sb.find("o", 5) == 7);
+            CHECK(sb.find("x") == std::string::npos);
+            CHECK(sb.find("") == 0);
+            CHECK(sb.find("", 12) == 12);
+            CHECK(sb.find("", 13) == std::string::npos);
+            CHECK(sb.compare("hello world!") == 0);
+            CHECK(sb.compare("hello") > 0);
+            CHECK(sb.compare("help") < 0);
+        }
+    }
+
+    GIVEN("an empty builder")
+    {
+        bosswestfalen::string_builder const sb;
+
+        THEN("it behaves like an empty string")
+        {
+            CHECK(sb.segments().begin() == sb.segments().end());
+            CHECK(sb.hash() == bosswestfalen::fnv1a(""));
+            CHECK(sb.equals(""));
+            CHECK(sb.starts_with(""));
+            CHECK(sb.find("") == 0);
+            CHECK(sb.find("a") == std::string::npos);
+            CHECK(sb.compare("") == 0);
+            CHECK(sb.compare("a") < 0);
+        }
+    }
+
+    GIVEN("builders with different storages")
+    {
+        bosswestfalen::string_builder sb;
+        bosswestfalen::basic_string_builder<std::deque> deque_sb;
+        sb.add("abc", "def");
+        deque_sb.add("abc");
+        deque_sb.add("def");
+
+        THEN("they can be compared")
+        {
+            CHECK(sb.equals(deque_sb));
+            CHECK(deque_sb.compare(sb) == 0);
+            deque_sb.add("g");
+            CHECK_FALSE(sb.equals(deque_sb));
+            CHECK(sb.compare(deque_sb) < 0);
+            CHECK(deque_sb.compare(sb) > 0);
+        }
+    }
+}
+
+
+TEST_CASE("segmented algorithms match the built string")
+{
+    std::mt19937 random{2018};
+    for (int i{0}; i < 500; ++i)
+    {
+        auto const text = random_text(random);
+        auto const other = random() % 4 == 0 ? text : random_text(random);
+        auto const needle = random_text(random).substr(0, random() % 5);
+        auto const position = static_cast<std::size_t>(random() % (text.size() + 2));
+        INFO("text: " << text << ", other: " << other << ", needle: " << needle << ", position: " << position);
+
+        bosswestfalen::string_builder sb;
+        bosswestfalen::basic_string_builder<std::deque> deque_sb;
+        bosswestfalen::basic_string_builder<std::list> list_sb;
+        add_in_pieces(sb, text, random);
+        add_in_pieces(deque_sb, text, random);
+        add_in_pieces(list_sb, other, random);
+        REQUIRE(sb.build() == text);
+        REQUIRE(list_sb.build() == other);
+
+        CHECK(sb.hash() == bosswestfalen::fnv1a(text));
+        CHECK(deque_sb.hash() == bosswestfalen::fnv1a(text));
+        CHECK(sb.equals(other) == (text == other));
+        CHECK(sb.equals(list_sb) == (text == other));
+        CHECK(sb.starts_with(needle) == (text.compare(0, needle.size(), needle) == 0));
+        CHECK(sb.starts_with(other) == (text.compare(0, other.size(), other) == 0));
+        CHECK(sb.find(needle, position) == text.find(needle, position));
+        CHECK(deque_sb.find(needle, position) == text.find(needle, position));
+        CHECK(list_sb.find(needle, position) == other.find(needle, position));
+        CHECK(sign(sb.compare(other)) == sign(text.compare(other)));
+        CHECK(sign(sb.compare(list_sb)) == sign(text.compare(other)));
+        CHECK(sign(list_sb.compare(deque_sb)) == sign(other.compare(text)));
+    }
+}
@@ -0,0 +1,214 @@
+#include <catch.hpp>
+#include <deque>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+template <typename Builder>
+std::size_t segment_count(Builder const& sb)
+{
+    std::size_t count{0};
+    sb.for_each_segment([&count](std::string_view)
+    {
+        ++count;
+    });
+    return count;
+}
+
+}
+
+
+SCENARIO("prepend")
+{
+    GIVEN("a string_builder with content")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add(std::string{"body"});
+
+        WHEN("values are prepended")
+        {
+            sb.prepend(42);
+            sb.prepend("<");
+            sb.prepend(test_type::has_sb_append{1});
+            sb.add(">");
+
+            THEN("they are in front in reverse order of prepending")
+            {
+                CHECK(sb.build() == "sb_append:1<42body>");
+                CHECK(sb.size() == 19);
+            }
+        }
+
+        WHEN("the builder is copied")
+        {
+            sb.prepend(std::string{"head:"});
+            auto const copy = sb;
+
+            THEN("the copy has the same content")
+            {
+                CHECK(copy.build() == "head:body");
+                CHECK(segment_count(copy) == 1);
+            }
+        }
+
+        WHEN("the result was cached before prepending")
+        {
+            CHECK(sb.build_cached() == "body");
+            sb.prepend_view("head:");
+
+            THEN("the cache is rebuilt")
+            {
+                CHECK(sb.build_cached() == "head:body");
+                CHECK(sb.take() == "head:body");
+                CHECK(sb.size() == 0);
+            }
+        }
+    }
+
+    GIVEN("a string_builder with std::deque as storage")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        sb.add("body");
+        sb.prepend(1.5);
+        sb.prepend_view("head:");
+
+        THEN("the values are in front")
+        {
+            CHECK(sb.build() == "head:1.5body");
+        }
+    }
+}
+
+
+SCENARIO("reserve_slot")
+{
+    GIVEN("a string_builder with a slot in front of the body")
+    {
+        bosswestfalen::string_builder sb;
+        auto const header = sb.reserve_slot(4, '0');
+        sb.add("payload");
+        sb.add(12345);
+
+        THEN("the slot is part of the result")
+        {
+            CHECK(header.size() == 4);
+            CHECK(sb.size() == 16);
+            CHECK(sb.build() == "0000payload12345");
+        }
+
+        WHEN("the slot is filled with the length of the body")
+        {
+            CHECK(header.fill(bosswestfalen::width(sb.size() - header.size(), 4, '0')) == 4);
+
+            THEN("the result contains the length")
+            {
+                CHECK(sb.build() == "0012payload12345");
+            }
+        }
+
+        WHEN("the slot is filled with a shorter value")
+        {
+            CHECK(header.fill("ab") == 2);
+
+            THEN("the other characters are unchanged")
+            {
+                CHECK(sb.build() == "ab00payload12345");
+            }
+        }
+
+        WHEN("the slot is filled with a longer value")
+        {
+            THEN("std::length_error is thrown and the slot is unchanged")
+            {
+                CHECK_THROWS_AS(header.fill(123456), std::length_error);
+                CHECK(sb.build() == "0000payload12345");
+            }
+        }
+
+        WHEN("the result is cached and the slot is filled afterwards")
+        {
+            CHECK(sb.build_cached() == "0000payload12345");
+            header.fill("1111");
+            sb.add("!");
+
+            THEN("the cache contains the new value")
+            {
+                CHECK(sb.build_cached() == "1111payload12345!");
+                header.fill("2222");
+                CHECK(sb.take() == "2222payload12345!");
+            }
+        }
+
+        WHEN("the builder is copied")
+        {
+            auto const copy = sb;
+            header.fill("abcd");
+
+            THEN("only the original is changed")
+            {
+                CHECK(sb.build() == "abcdpayload12345");
+                CHECK(copy.build() == "0000payload12345");
+            }
+        }
+
+        WHEN("values are prepended")
+        {
+            sb.prepend("pre:");
+            CHECK(sb.build_cached() == "pre:0000payload12345");
+            header.fill("1234");
+
+            THEN("the slot is still used")
+            {
+                CHECK(sb.build_cached() == "pre:1234payload12345");
+            }
+        }
+    }
+
+    GIVEN("a length-prefixed frame")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add("HDR");
+        auto const length = sb.reserve_slot(8);
+        auto const begin = sb.size();
+        for (int i{0}; i < 1000; ++i)
+        {
+            sb.add(i, ";");
+        }
+        length.fill(sb.size() - begin);
+
+        THEN("the frame is built in a single pass")
+        {
+            auto const frame = sb.build();
+            CHECK(frame.substr(0, 11) == "HDR3890    ");
+            CHECK(frame.size() == 11 + 3890);
+        }
+    }
+
+    GIVEN("a string_builder with std::list as storage")
+    {
+        bosswestfalen::basic_string_builder<std::list> sb;
+        auto const first = sb.reserve_slot(2, '-');
+        for (int i{0}; i < 100; ++i)
+        {
+            sb.add(std::string(100, 'x'));
+        }
+        auto const second = sb.reserve_slot(1);
+        first.fill(99);
+        second.fill("!");
+
+        THEN("all slots are valid")
+        {
+            auto const result = sb.build();
+            CHECK(result.size() == 2 + 100 * 100 + 1);
+            CHECK(result.substr(0, 3) == "99x");
+            CHECK(result.back() == '!');
+        }
+    }
+}
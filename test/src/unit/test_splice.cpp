@@ -0,0 +1,330 @@
+#include <catch.hpp>
+#include <deque>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+/// `std::allocator` whose strings are at most about 100 characters long.
+template <typename T>
+struct small_allocator
+{
+    using value_type = T;
+
+    small_allocator() = default;
+
+    template <typename U>
+    small_allocator(small_allocator<U> const&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t const count)
+    {
+        return std::allocator<T>{}.allocate(count);
+    }
+
+    void deallocate(T* const memory, std::size_t const count) noexcept
+    {
+        std::allocator<T>{}.deallocate(memory, count);
+    }
+
+    std::size_t max_size() const noexcept
+    {
+        return 100;
+    }
+
+    friend bool operator==(small_allocator const&, small_allocator const&) noexcept
+    {
+        return true;
+    }
+
+    friend bool operator!=(small_allocator const&, small_allocator const&) noexcept
+    {
+        return false;
+    }
+};
+
+/// Numbers from `first` to `last` (exclusive), each followed by a comma.
+std::string numbers(int const first, int const last)
+{
+    std::string result;
+    for (int i{first}; i < last; ++i)
+    {
+        result += std::to_string(i) + ",";
+    }
+    return result;
+}
+
+/// Add the numbers from `first` to `last` (exclusive) to `sb`, each followed by a comma.
+template <typename Builder>
+void fill(Builder& sb, int const first, int const last)
+{
+    for (int i{first}; i < last; ++i)
+    {
+        sb.add(i, ",");
+    }
+}
+
+}
+
+
+SCENARIO("adding a builder to a builder")
+{
+    GIVEN("an outer and an inner string_builder")
+    {
+        bosswestfalen::string_builder outer;
+        bosswestfalen::string_builder inner;
+        fill(outer, 0, 1000);
+        inner.prepend("header,");
+        fill(inner, 1000, 5000);
+        inner.add_view("view,");
+        auto const expected = numbers(0, 1000) + "header," + numbers(1000, 5000) + "view,";
+
+        WHEN("the inner builder is moved into the outer one")
+        {
+            auto const inner_size = inner.size();
+            auto const inner_data = (*inner.segments().begin()).data();
+            outer.add(std::move(inner));
+
+            THEN("the characters are not copied")
+            {
+                auto found = false;
+                for (auto const segment : outer.segments())
+                {
+                    found = found or segment.data() == inner_data;
+                }
+                CHECK(found);
+            }
+
+            THEN("the outer builder contains both and the inner one is empty")
+            {
+                CHECK(outer.build() == expected);
+                CHECK(outer.size() == expected.size());
+                CHECK(inner.size() == 0);
+                CHECK(inner.build().empty());
+                CHECK(inner_size == expected.size() - numbers(0, 1000).size());
+            }
+
+            THEN("both builders can be used further")
+            {
+                fill(outer, 5000, 6000);
+                fill(inner, 0, 10);
+                outer.prepend("first,");
+                CHECK(outer.build() == "first," + expected + numbers(5000, 6000));
+                CHECK(inner.build() == numbers(0, 10));
+            }
+
+            THEN("the outer builder can be cleared and reused")
+            {
+                outer.clear();
+                fill(outer, 0, 10000);
+                CHECK(outer.build() == numbers(0, 10000));
+            }
+        }
+
+        WHEN("the inner builder has a slot")
+        {
+            bosswestfalen::string_builder with_slot;
+            with_slot.add("size=");
+            auto const slot = with_slot.reserve_slot(4, ' ');
+            outer.build_cached();
+            outer.add(std::move(with_slot));
+            slot.fill(42);
+
+            THEN("the slot stays valid")
+            {
+                CHECK(outer.build() == numbers(0, 1000) + "size=42  ");
+                CHECK(outer.build_cached() == numbers(0, 1000) + "size=42  ");
+            }
+        }
+
+        WHEN("nested builders are moved several times")
+        {
+            bosswestfalen::string_builder document;
+            document.add("<doc>");
+            for (int section{0}; section < 3; ++section)
+            {
+                bosswestfalen::string_builder part;
+                part.add("<section>");
+                bosswestfalen::string_builder body;
+                fill(body, 0, 100);
+                part.add(std::move(body));
+                part.add("</section>");
+                document.add(std::move(part));
+            }
+            document.add("</doc>");
+
+            THEN("the result is the concatenation")
+            {
+                auto const section = "<section>" + numbers(0, 100) + "</section>";
+                CHECK(document.build() == "<doc>" + section + section + section + "</doc>");
+            }
+        }
+
+        WHEN("the inner builder is copied into the outer one")
+        {
+            outer.add(static_cast<bosswestfalen::string_builder const&>(inner));
+            outer.add(inner);
+
+            THEN("both builders contain the content")
+            {
+                auto const inner_result = inner.build();
+                CHECK(outer.build() == numbers(0, 1000) + inner_result + inner_result);
+                CHECK(inner_result == "header," + numbers(1000, 5000) + "view,");
+            }
+        }
+
+        WHEN("the inner builder is shared")
+        {
+            outer.add_view(inner);
+
+            THEN("the outer builder refers to the content")
+            {
+                CHECK(outer.build() == expected);
+                CHECK(inner.build() == "header," + numbers(1000, 5000) + "view,");
+            }
+        }
+
+        WHEN("a builder is added to itself")
+        {
+            outer.add(std::move(outer));
+            outer.add_view(outer);
+
+            THEN("its content is repeated")
+            {
+                auto const twice = numbers(0, 1000) + numbers(0, 1000);
+                CHECK(outer.build() == twice + twice);
+            }
+        }
+    }
+
+    GIVEN("a string_builder with several chunks")
+    {
+        bosswestfalen::string_builder sb;
+        fill(sb, 0, 5000);
+        auto const data = (*sb.segments().begin()).data();
+
+        WHEN("it is move constructed")
+        {
+            auto moved = std::move(sb);
+
+            THEN("the chunks are handed over")
+            {
+                CHECK((*moved.segments().begin()).data() == data);
+                CHECK(moved.build() == numbers(0, 5000));
+            }
+
+            THEN("the moved-from builder is empty and can be used again")
+            {
+                CHECK(sb.size() == 0);
+                CHECK(sb.build().empty());
+                fill(sb, 0, 10);
+                CHECK(sb.size() == numbers(0, 10).size());
+                CHECK(sb.build() == numbers(0, 10));
+            }
+        }
+
+        WHEN("it is move assigned")
+        {
+            bosswestfalen::string_builder moved;
+            moved.add("old");
+            moved = std::move(sb);
+
+            THEN("the chunks are handed over and the moved-from builder is empty")
+            {
+                CHECK((*moved.segments().begin()).data() == data);
+                CHECK(moved.build() == numbers(0, 5000));
+                CHECK(sb.size() == 0);
+                CHECK(sb.build().empty());
+            }
+        }
+
+        WHEN("it is copied")
+        {
+            auto const copy = sb;
+
+            THEN("the characters are copied")
+            {
+                CHECK((*copy.segments().begin()).data() != data);
+                CHECK(copy.build() == sb.build());
+            }
+        }
+    }
+
+    GIVEN("a builder with std::vector as storage")
+    {
+        bosswestfalen::basic_string_builder<std::vector> sb;
+        fill(sb, 0, 100);
+        auto const slot = sb.reserve_slot(2);
+        sb.build_cached();
+
+        WHEN("it is moved")
+        {
+            auto moved = std::move(sb);
+            slot.fill(42);
+
+            THEN("the moved-from builder is empty and can be used again")
+            {
+                CHECK(moved.build() == numbers(0, 100) + "42");
+                CHECK(sb.size() == 0);
+                CHECK(sb.build().empty());
+                CHECK(sb.build_cached().empty());
+                sb.add("x");
+                CHECK(sb.size() == 1);
+                CHECK(sb.build() == "x");
+            }
+        }
+    }
+
+    GIVEN("builders with containers as storage")
+    {
+        bosswestfalen::basic_string_builder<std::deque> outer;
+        bosswestfalen::basic_string_builder<std::deque> inner;
+        bosswestfalen::basic_string_builder<std::list> list_outer;
+        bosswestfalen::basic_string_builder<std::list> list_inner;
+        fill(outer, 0, 10);
+        fill(inner, 10, 20);
+        fill(list_outer, 0, 10);
+        fill(list_inner, 10, 20);
+        outer.add_view(inner);
+        outer.add(std::move(inner));
+        list_outer.add(std::move(list_inner));
+
+        THEN("the strings are moved")
+        {
+            CHECK(outer.build() == numbers(0, 20) + numbers(10, 20));
+            CHECK(inner.size() == 0);
+            CHECK(list_outer.build() == numbers(0, 20));
+            CHECK(list_inner.build().empty());
+        }
+    }
+
+    GIVEN("builders whose results are limited")
+    {
+        using builder = bosswestfalen::basic_string_builder<bosswestfalen::chunked_storage,
+                                                            bosswestfalen::no_statistics, small_allocator<char>>;
+        builder outer;
+        builder inner;
+        auto const half = builder::string_type{}.max_size() / 2 + 1;
+        outer.add(std::string(half, 'o'));
+        inner.add(std::string(half, 'i'));
+
+        WHEN("the result would be too large")
+        {
+            THEN("std::length_error is thrown and both builders are unchanged")
+            {
+                CHECK_THROWS_AS(outer.add(std::move(inner)), std::length_error);
+                CHECK_THROWS_AS(outer.add_view(inner), std::length_error);
+                CHECK_THROWS_AS(outer.add(inner), std::length_error);
+                CHECK(outer.equals(std::string(half, 'o')));
+                CHECK(inner.equals(std::string(half, 'i')));
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+constexpr auto make_header()
+{
+    bosswestfalen::static_string_builder<32> sb;
+    sb.add("version=");
+    sb.add(2);
+    sb.add(" id=");
+    sb.add(-1234567890123LL);
+    return sb;
+}
+
+}
+
+TEST_CASE("static_string_builder in constant expressions")
+{
+    constexpr auto header = make_header();
+    static_assert(header.view() == "version=2 id=-1234567890123");
+    CHECK(std::string{"version=2 id=-1234567890123"} == header.build());
+}
+
+SCENARIO("static_string_builder")
+{
+    GIVEN("an empty static_string_builder")
+    {
+        bosswestfalen::static_string_builder<32> sb;
+
+        WHEN("its result is requested")
+        {
+            THEN("it is an empty string")
+            {
+                CHECK(sb.view().empty());
+                CHECK(std::string{} == sb.build());
+            }
+        }
+
+        WHEN("values of all conversion paths are added")
+        {
+            sb.add(std::string{"a"});
+            sb.add(true);
+            sb.add(test_type::has_sb_append{1});
+            sb.add(test_type::has_operator_ll{});
+
+            THEN("the conversion rules of append_to are used")
+            {
+                CHECK(std::string_view{"a1sb_append:1stream"} == sb.view());
+            }
+        }
+    }
+
+    GIVEN("a static_string_builder that throws on overflow")
+    {
+        bosswestfalen::static_string_builder<8> sb;
+        sb.add("cat");
+
+        WHEN("the capacity is exceeded")
+        {
+            THEN("std::length_error is thrown and the content is unchanged")
+            {
+                CHECK_THROWS_AS(sb.add("elephant"), std::length_error);
+                CHECK_THROWS_AS(sb.add(test_type::has_sb_append{}), std::length_error);
+                CHECK(std::string_view{"cat"} == sb.view());
+                sb.add("dog");
+                CHECK(std::string_view{"catdog"} == sb.view());
+            }
+        }
+    }
+
+    GIVEN("a static_string_builder that truncates")
+    {
+        bosswestfalen::static_string_builder<8, bosswestfalen::overflow_policy::truncate> sb;
+        sb.add("cat");
+        CHECK_FALSE(sb.truncated());
+
+        WHEN("the capacity is exceeded")
+        {
+            sb.add(test_type::has_sb_append{});
+            sb.add("dog");
+
+            THEN("the content is truncated")
+            {
+                CHECK(sb.truncated());
+                CHECK(std::string_view{"catsb_ap"} == sb.view());
+            }
+        }
+    }
+
+    GIVEN("a static_string_builder that spills to the heap")
+    {
+        bosswestfalen::static_string_builder<8, bosswestfalen::overflow_policy::spill> sb;
+        sb.add("cat");
+
+        WHEN("the capacity is exceeded")
+        {
+            sb.add(test_type::has_sb_append{});
+            sb.add(1.5);
+
+            THEN("the content is complete")
+            {
+                CHECK(std::string{"catsb_append:421.5"} == sb.build());
+            }
+        }
+    }
+}
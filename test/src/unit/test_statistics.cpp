@@ -0,0 +1,250 @@
+#include <catch.hpp>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+/// Policy counting the conversions of a single call site.
+struct call_site_statistics final
+{
+    static constexpr bool enabled{true};
+
+    static inline std::size_t stream_conversions{0};
+    static inline std::size_t fragments{0};
+
+    static void on_conversion(bosswestfalen::conversion_path const path)
+    {
+        if (path == bosswestfalen::conversion_path::stream_operator)
+        {
+            ++stream_conversions;
+        }
+    }
+
+    static void on_fragment(std::size_t)
+    {
+        ++fragments;
+    }
+
+    static void on_allocations(std::size_t)
+    {
+    }
+
+    static void on_build(std::size_t, std::uint64_t)
+    {
+    }
+};
+
+std::uint64_t conversions(bosswestfalen::statistics_snapshot const& statistics, bosswestfalen::conversion_path const path)
+{
+    return statistics.conversions[static_cast<std::size_t>(path)];
+}
+
+}
+
+
+TEST_CASE("conversion paths")
+{
+    using bosswestfalen::conversion_path;
+    using bosswestfalen::detail::conversion_path_of;
+
+    static_assert(conversion_path_of<char const(&)[4]>() == conversion_path::view);
+    static_assert(conversion_path_of<int>() == conversion_path::arithmetic);
+    static_assert(conversion_path_of<double const&>() == conversion_path::arithmetic);
+    static_assert(conversion_path_of<std::string&>() == conversion_path::string_conversion);
+    static_assert(conversion_path_of<char const*>() == conversion_path::string_conversion);
+    static_assert(conversion_path_of<test_type::has_operator_string>() == conversion_path::string_conversion);
+    static_assert(conversion_path_of<test_type::has_sb_append>() == conversion_path::custom_hook);
+    static_assert(conversion_path_of<test_type::has_sb_append_and_to_string>() == conversion_path::custom_hook);
+    static_assert(conversion_path_of<test_type::has_external_to_string>() == conversion_path::external_to_string);
+    static_assert(conversion_path_of<test_type::has_operator_ll>() == conversion_path::stream_operator);
+    static_assert(conversion_path_of<test_type::convertible_to_int>() == conversion_path::stream_operator);
+
+    CHECK(bosswestfalen::conversion_path_name(conversion_path::stream_operator) == "stream_operator");
+}
+
+
+TEST_CASE("histogram buckets")
+{
+    using snapshot = bosswestfalen::statistics_snapshot;
+
+    CHECK(snapshot::bucket(0) == 0);
+    CHECK(snapshot::bucket(1) == 1);
+    CHECK(snapshot::bucket(2) == 2);
+    CHECK(snapshot::bucket(3) == 2);
+    CHECK(snapshot::bucket(4) == 3);
+    CHECK(snapshot::bucket(4095) == 12);
+    CHECK(snapshot::bucket(4096) == 13);
+    CHECK(snapshot::bucket(std::size_t{1} << 40) == snapshot::histogram_size - 1);
+}
+
+
+TEST_CASE("instrumented_string_builder")
+{
+    using bosswestfalen::conversion_path;
+
+    bosswestfalen::reset_statistics();
+    bosswestfalen::instrumented_string_builder sb;
+
+    SECTION("add counts conversions and fragments")
+    {
+        sb.add("lit");
+        sb.add(42);
+        sb.add(std::string{"string"});
+        sb.add(test_type::has_sb_append{});
+        sb.add(test_type::has_external_to_string{});
+        sb.add(test_type::has_operator_ll{});
+        sb.add_view("view");
+
+        auto const statistics = bosswestfalen::thread_statistics();
+        CHECK(conversions(statistics, conversion_path::view) == 2);
+        CHECK(conversions(statistics, conversion_path::arithmetic) == 1);
+        CHECK(conversions(statistics, conversion_path::string_conversion) == 1);
+        CHECK(conversions(statistics, conversion_path::custom_hook) == 1);
+        CHECK(conversions(statistics, conversion_path::external_to_string) == 1);
+        CHECK(conversions(statistics, conversion_path::stream_operator) == 1);
+        CHECK(statistics.fragments == 7);
+        CHECK(statistics.fragment_bytes == sb.size());
+        CHECK(statistics.fragment_sizes[bosswestfalen::statistics_snapshot::bucket(2)] == 2);
+        CHECK(statistics.allocations == 1);
+        CHECK(statistics.builds == 0);
+    }
+
+    SECTION("add of several values counts every value and one fragment")
+    {
+        sb.add("a", 1, test_type::has_operator_ll{});
+
+        // the literal is copied into the fragment
+        auto const statistics = bosswestfalen::thread_statistics();
+        CHECK(conversions(statistics, conversion_path::string_conversion) == 1);
+        CHECK(conversions(statistics, conversion_path::arithmetic) == 1);
+        CHECK(conversions(statistics, conversion_path::stream_operator) == 1);
+        CHECK(statistics.fragments == 1);
+        CHECK(statistics.fragment_bytes == 8);
+    }
+
+    SECTION("large fragments allocate chunks")
+    {
+        sb.add(std::string(10000, 'x'));
+        sb.add(std::string(100000, 'y'));
+
+        CHECK(bosswestfalen::thread_statistics().allocations == 2);
+    }
+
+    SECTION("builds count copied bytes")
+    {
+        sb.add(std::string(100, 'x'));
+        sb.add_view("abc");
+        CHECK(sb.build().size() == 103);
+        std::string target;
+        sb.build_into(target);
+        sb.build_cached();
+
+        auto const statistics = bosswestfalen::thread_statistics();
+        CHECK(statistics.builds == 3);
+        CHECK(statistics.bytes_copied == 3 * 103);
+    }
+
+    SECTION("moving a builder in counts one fragment")
+    {
+        bosswestfalen::instrumented_string_builder large;
+        bosswestfalen::instrumented_string_builder small;
+        large.add(std::string(10000, 'x'));
+        small.add(std::string(2, 'y'));
+        sb.add(1);
+        bosswestfalen::reset_statistics();
+
+        // the chunk of `large` is taken over, `small` is copied into the chunk of `sb`
+        sb.add(std::move(large));
+        sb.add(std::move(small));
+        CHECK(sb.build().size() == 10003);
+
+        auto const statistics = bosswestfalen::thread_statistics();
+        CHECK(conversions(statistics, conversion_path::view) == 2);
+        CHECK(statistics.fragments == 2);
+        CHECK(statistics.fragment_bytes == 10002);
+        CHECK(statistics.allocations == 0);
+        CHECK(statistics.bytes_copied == 10003);
+    }
+
+    SECTION("reset")
+    {
+        sb.add(1);
+        bosswestfalen::reset_statistics();
+        CHECK(bosswestfalen::thread_statistics().fragments == 0);
+    }
+
+    SECTION("report")
+    {
+        sb.add(1);
+        sb.add(std::string(5, 'x'));
+        sb.build();
+
+        std::ostringstream report;
+        report << bosswestfalen::thread_statistics();
+        CHECK(report.str() == "conversions: view=0 arithmetic=1 string_conversion=1 custom_hook=0 "
+                              "external_to_string=0 stream_operator=0\n"
+                              "fragments: 2 (6 bytes)\n"
+                              "fragment sizes: [1,2)=1 [4,8)=1\n"
+                              "allocations: 1\n"
+                              "builds: 1 (6 bytes copied, " + std::to_string(bosswestfalen::thread_statistics().build_nanoseconds) + " ns)\n");
+    }
+}
+
+
+TEST_CASE("global statistics include finished threads")
+{
+    bosswestfalen::reset_statistics();
+
+    std::thread worker{[]
+    {
+        bosswestfalen::basic_string_builder<std::deque, bosswestfalen::collect_statistics> sb;
+        sb.add(1);
+        sb.add(2);
+    }};
+    worker.join();
+
+    bosswestfalen::instrumented_string_builder sb;
+    sb.add(3);
+
+    auto const statistics = bosswestfalen::global_statistics();
+    CHECK(statistics.fragments == 3);
+    CHECK(statistics.allocations == 3);
+    CHECK(bosswestfalen::thread_statistics().fragments == 1);
+}
+
+
+TEST_CASE("custom statistics policy")
+{
+    call_site_statistics::stream_conversions = 0;
+    call_site_statistics::fragments = 0;
+
+    bosswestfalen::basic_string_builder<bosswestfalen::chunked_storage, call_site_statistics> sb;
+    sb.add(test_type::has_operator_ll{});
+    sb.add(test_type::convertible_to_int{});
+    sb.add(1);
+
+    CHECK(call_site_statistics::stream_conversions == 2);
+    CHECK(call_site_statistics::fragments == 3);
+    CHECK(sb.build() == "stream12341");
+}
+
+
+TEST_CASE("disabled statistics do not change the builder")
+{
+    static_assert(sizeof(bosswestfalen::string_builder) == sizeof(bosswestfalen::instrumented_string_builder));
+
+    bosswestfalen::reset_statistics();
+    bosswestfalen::string_builder sb;
+    sb.add(1);
+    sb.build();
+
+    auto const statistics = bosswestfalen::thread_statistics();
+    CHECK(statistics.fragments == 0);
+    CHECK(statistics.builds == 0);
+}
@@ -0,0 +1,204 @@
+#include <catch.hpp>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+namespace
+{
+
+/// Changes the formatting state of the stream and does not restore it.
+struct changes_format final
+{
+    double value{1.0 / 3.0};
+};
+
+std::ostream& operator<<(std::ostream& stream, changes_format const& x)
+{
+    return stream << std::hex << std::showbase << std::setprecision(2) << std::setfill('*')
+                  << std::setw(6) << 255 << ' ' << x.value;
+}
+
+
+/// Changes the formatting state of the stream only if `change` is set.
+struct changes_format_if final
+{
+    bool change{false};
+};
+
+std::ostream& operator<<(std::ostream& stream, changes_format_if const& x)
+{
+    if (x.change)
+    {
+        stream << std::hex << std::uppercase << std::setfill('*');
+    }
+    return stream << std::setw(4) << 255;
+}
+
+
+struct prints_number final
+{
+    int value{255};
+    double fraction{1.0 / 3.0};
+};
+
+std::ostream& operator<<(std::ostream& stream, prints_number const& x)
+{
+    return stream << std::setw(5) << x.value << ' ' << x.fraction;
+}
+
+
+/// Converts another streamed value while being streamed.
+struct nested final
+{
+};
+
+std::ostream& operator<<(std::ostream& stream, nested const&)
+{
+    return stream << '<' << bosswestfalen::make_string(prints_number{}) << '>';
+}
+
+
+struct long_output final
+{
+    std::size_t size{1000};
+};
+
+std::ostream& operator<<(std::ostream& stream, long_output const& x)
+{
+    for (std::size_t i{0}; i < x.size; ++i)
+    {
+        stream << static_cast<char>('a' + i % 26);
+    }
+    return stream << std::string(x.size, 'x');
+}
+
+std::string expected_long_output(std::size_t const size)
+{
+    std::string result;
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        result += static_cast<char>('a' + i % 26);
+    }
+    return result + std::string(size, 'x');
+}
+
+
+struct throws final
+{
+};
+
+std::ostream& operator<<(std::ostream& stream, throws const&)
+{
+    stream << "partial";
+    throw std::runtime_error{"throws"};
+}
+
+
+/// Changes the formatting state of the stream and throws if `fail` is set.
+struct throws_if final
+{
+    bool fail{false};
+};
+
+std::ostream& operator<<(std::ostream& stream, throws_if const& x)
+{
+    if (x.fail)
+    {
+        stream << std::hex << std::setprecision(1) << "partial";
+        throw std::runtime_error{"throws_if"};
+    }
+    return stream << 255 << ' ' << 1.0 / 3.0;
+}
+
+
+/// `sink` that fails after `limit` characters.
+class limited_sink final : public bosswestfalen::sink
+{
+  public:
+    std::string text;
+
+  private:
+    void do_append(char const* data, std::size_t count) override
+    {
+        if (text.size() + count > 10)
+        {
+            throw std::length_error{"limited_sink"};
+        }
+        text.append(data, count);
+    }
+};
+
+}
+
+
+TEST_CASE("stream conversion")
+{
+    SECTION("simple values")
+    {
+        CHECK(std::string{"stream"} == bosswestfalen::make_string(test_type::has_operator_ll{}));
+        CHECK(std::string{"1234"} == bosswestfalen::make_string(test_type::convertible_to_int{}));
+    }
+
+    SECTION("formatting state does not leak between conversions")
+    {
+        CHECK(std::string{"**0xff 0.33"} == bosswestfalen::make_string(changes_format{}));
+        CHECK(std::string{"  255 0.333333"} == bosswestfalen::make_string(prints_number{}));
+    }
+
+    SECTION("formatting state does not leak to the next value of the same type")
+    {
+        CHECK(std::string{"**FF"} == bosswestfalen::make_string(changes_format_if{true}));
+        CHECK(std::string{" 255"} == bosswestfalen::make_string(changes_format_if{false}));
+        CHECK(std::string{"**FF"} == bosswestfalen::make_string(changes_format_if{true}));
+        CHECK(std::string{" 255"} == bosswestfalen::make_string(changes_format_if{false}));
+    }
+
+    SECTION("nested conversions")
+    {
+        CHECK(std::string{"<  255 0.333333>"} == bosswestfalen::make_string(nested{}));
+        CHECK(std::string{"  255 0.333333"} == bosswestfalen::make_string(prints_number{}));
+    }
+
+    SECTION("output larger than the internal buffer")
+    {
+        for (std::size_t const size : {0, 1, 255, 256, 257, 1000, 100000})
+        {
+            CHECK(expected_long_output(size) == bosswestfalen::make_string(long_output{size}));
+        }
+    }
+
+    SECTION("exception thrown by operator<<")
+    {
+        CHECK_THROWS_AS(bosswestfalen::make_string(throws{}), std::runtime_error);
+        CHECK(std::string{"stream"} == bosswestfalen::make_string(test_type::has_operator_ll{}));
+    }
+
+    SECTION("exception thrown by operator<< and the same type streamed again")
+    {
+        CHECK_THROWS_AS(bosswestfalen::make_string(throws_if{true}), std::runtime_error);
+        CHECK(std::string{"255 0.333333"} == bosswestfalen::make_string(throws_if{false}));
+        CHECK_THROWS_AS(bosswestfalen::make_string(throws_if{true}), std::runtime_error);
+        CHECK(std::string{"255 0.333333"} == bosswestfalen::make_string(throws_if{false}));
+    }
+
+    SECTION("exception thrown by the sink")
+    {
+        limited_sink out;
+        CHECK_THROWS_AS(bosswestfalen::append_to(out, long_output{20}), std::length_error);
+        CHECK(std::string{"stream"} == bosswestfalen::make_string(test_type::has_operator_ll{}));
+    }
+
+    SECTION("streamed values in a builder")
+    {
+        bosswestfalen::string_builder sb;
+        sb.add(changes_format{});
+        sb.add("|");
+        sb.add(prints_number{});
+        sb.add(test_type::has_operator_ll{}, prints_number{});
+        CHECK(std::string{"**0xff 0.33|  255 0.333333stream  255 0.333333"} == sb.build());
+    }
+}
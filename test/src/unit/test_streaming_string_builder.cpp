@@ -0,0 +1,145 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <string_builder.hpp>
+#include "helper_types.hpp"
+
+
+SCENARIO("streaming string builder")
+{
+    GIVEN("a streaming builder writing to a callable")
+    {
+        std::vector<std::string> flushed;
+        bosswestfalen::streaming_string_builder sb{[&flushed](std::string_view const text)
+        {
+            flushed.emplace_back(text);
+        }, 100};
+
+        WHEN("less than the high-water mark is added")
+        {
+            sb.add("cat");
+            sb.add(1, test_type::has_sb_append{});
+
+            THEN("nothing is flushed")
+            {
+                CHECK(flushed.empty());
+                CHECK(0 == sb.bytes_written());
+                CHECK(16 == sb.bytes_buffered());
+            }
+        }
+
+        WHEN("much more than the high-water mark is added")
+        {
+            std::string expected;
+            for (int i{0}; i < 10000; ++i)
+            {
+                sb.add(i);
+                expected += std::to_string(i);
+            }
+            sb.flush();
+
+            THEN("the content is flushed in parts of bounded size")
+            {
+                std::string received;
+                for (auto const& part : flushed)
+                {
+                    CHECK(part.size() < 100 + 5);
+                    received += part;
+                }
+                CHECK(expected == received);
+                CHECK(expected.size() == sb.bytes_written());
+                CHECK(0 == sb.bytes_buffered());
+            }
+        }
+
+        WHEN("a large view is added")
+        {
+            std::string const large(1000, 'l');
+            sb.add("cat");
+            sb.add_view(large);
+
+            THEN("it is passed directly after the buffered content")
+            {
+                REQUIRE(2 == flushed.size());
+                CHECK(std::string{"cat"} == flushed[0]);
+                CHECK(large == flushed[1]);
+            }
+        }
+    }
+
+    GIVEN("a streaming builder writing to a std::ostream")
+    {
+        std::ostringstream stream;
+
+        WHEN("content is added and the builder is destroyed")
+        {
+            {
+                bosswestfalen::basic_streaming_string_builder sb{bosswestfalen::ostream_output{stream}};
+                sb.add("cat");
+                sb.add(test_type::has_operator_ll{});
+            }
+
+            THEN("the remaining content is flushed")
+            {
+                CHECK(std::string{"catstream"} == stream.str());
+            }
+        }
+    }
+
+    GIVEN("a streaming builder writing to a file descriptor")
+    {
+        auto file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        auto const fd = ::fileno(file);
+
+        WHEN("content is added and flushed")
+        {
+            bosswestfalen::basic_streaming_string_builder sb{bosswestfalen::fd_output{fd}, 16};
+            std::string expected;
+            for (int i{0}; i < 1000; ++i)
+            {
+                sb.add(i, ",");
+                expected += std::to_string(i) + ",";
+            }
+            sb.flush();
+
+            THEN("the file contains the content")
+            {
+                std::string content(expected.size() + 1, '\0');
+                auto const count = ::pread(fd, content.data(), content.size(), 0);
+                CHECK(expected == content.substr(0, static_cast<std::size_t>(count)));
+            }
+        }
+        std::fclose(file);
+    }
+
+    GIVEN("a streaming builder with a failing output")
+    {
+        auto fail = true;
+        std::string received;
+        bosswestfalen::streaming_string_builder sb{[&](std::string_view const text)
+        {
+            if (fail)
+            {
+                throw std::runtime_error{"fail"};
+            }
+            received += text;
+        }, 4};
+
+        WHEN("flushing fails")
+        {
+            CHECK_THROWS_AS(sb.add("catdog"), std::runtime_error);
+
+            THEN("the content is kept until the next flush")
+            {
+                fail = false;
+                sb.flush();
+                CHECK(std::string{"catdog"} == received);
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include <catch.hpp>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <string_builder.hpp>
+
+
+SCENARIO("adding views")
+{
+    GIVEN("a string_builder and a buffer")
+    {
+        bosswestfalen::string_builder sb;
+        std::string buffer{"cat"};
+
+        WHEN("the buffer is added as view and changed afterwards")
+        {
+            sb.add("<");
+            sb.add_view(buffer);
+            sb.add(">");
+            buffer[0] = 'h';
+
+            THEN("the result refers to the changed buffer")
+            {
+                CHECK(std::string{"<hat>"} == sb.build());
+            }
+        }
+
+        WHEN("the buffer is added by value and changed afterwards")
+        {
+            sb.add(std::string_view{buffer});
+            buffer[0] = 'h';
+
+            THEN("the result contains the original characters")
+            {
+                CHECK(std::string{"cat"} == sb.build());
+            }
+        }
+
+        WHEN("the builder is copied")
+        {
+            sb.add_view(buffer);
+            auto const copy{sb};
+            buffer[0] = 'h';
+
+            THEN("the copy owns its characters")
+            {
+                CHECK(std::string{"hat"} == sb.build());
+                CHECK(std::string{"cat"} == copy.build());
+            }
+        }
+    }
+
+    GIVEN("a string_builder using std::deque and a buffer")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        std::string buffer{"cat"};
+
+        WHEN("the buffer is added as view and changed afterwards")
+        {
+            sb.add_view(buffer);
+            buffer[0] = 'h';
+
+            THEN("the characters were copied")
+            {
+                CHECK(std::string{"cat"} == sb.build());
+            }
+        }
+    }
+
+    GIVEN("a string_builder")
+    {
+        bosswestfalen::string_builder sb;
+
+        WHEN("literals are added")
+        {
+            sb.add("user=");
+            sb.add(42);
+            sb.add(" with\0hidden");
+            sb.add("");
+
+            THEN("all characters but the terminating null character are stored")
+            {
+                CHECK(std::string{"user=42 with\0hidden", 19} == sb.build());
+            }
+        }
+
+        WHEN("arrays without terminating null character are added")
+        {
+            char const tag[3]{'a', 'b', 'c'};
+            sb.add(tag);
+            sb.prepend(tag);
+
+            THEN("only the characters of the arrays are read")
+            {
+                CHECK(std::string{"abcabc"} == sb.build());
+            }
+        }
+
+        WHEN("a non-const char array is added")
+        {
+            char array[]{"cat"};
+            sb.add(array);
+            array[0] = 'h';
+
+            THEN("its characters are copied")
+            {
+                CHECK(std::string{"cat"} == sb.build());
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string_builder.hpp>
+
+
+namespace
+{
+
+/// read everything from `fd` until end of file
+std::string read_all(int const fd)
+{
+    std::string result;
+    char buffer[4096];
+    for (;;)
+    {
+        auto const count = ::read(fd, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            return result;
+        }
+        result.append(buffer, static_cast<std::size_t>(count));
+    }
+}
+
+/// write `sb` to a pipe and return what was read from the other end
+template <typename Builder>
+std::string through_pipe(Builder const& sb)
+{
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    std::string received;
+    std::thread reader{[&received, fd = fds[0]]
+    {
+        received = read_all(fd);
+    }};
+    auto const written = sb.write_to(fds[1]);
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+    CHECK(written == received.size());
+    return received;
+}
+
+}
+
+SCENARIO("writing to a file descriptor")
+{
+    GIVEN("a string_builder with content")
+    {
+        bosswestfalen::string_builder sb;
+        std::string expected;
+        for (int i{0}; i < 100000; ++i)
+        {
+            sb.add(i);
+            expected += std::to_string(i);
+        }
+
+        WHEN("it is written to a pipe")
+        {
+            THEN("the result of build() is received")
+            {
+                CHECK(expected == through_pipe(sb));
+            }
+        }
+
+        WHEN("it is written to a file")
+        {
+            auto file = std::tmpfile();
+            REQUIRE(file != nullptr);
+            auto const fd = ::fileno(file);
+            sb.write_to(fd);
+            ::lseek(fd, 0, SEEK_SET);
+
+            THEN("the file contains the result of build()")
+            {
+                CHECK(expected == read_all(fd));
+            }
+            std::fclose(file);
+        }
+
+        WHEN("it is written to an invalid file descriptor")
+        {
+            THEN("std::system_error is thrown")
+            {
+                CHECK_THROWS_AS(sb.write_to(-1), std::system_error);
+            }
+        }
+
+        WHEN("it is written to a full non-blocking pipe")
+        {
+            int fds[2];
+            REQUIRE(::pipe(fds) == 0);
+            REQUIRE(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+
+            THEN("EAGAIN is thrown instead of waiting")
+            {
+                try
+                {
+                    sb.write_to(fds[1]);
+                    FAIL("no exception thrown");
+                }
+                catch (std::system_error const& error)
+                {
+                    CHECK(error.code() == std::errc::resource_unavailable_try_again);
+                }
+            }
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+    }
+
+    GIVEN("buffers that are all empty")
+    {
+        char text[]{"abc"};
+        std::vector<iovec> buffers(3, iovec{text, 0});
+
+        THEN("nothing is written and no error is reported")
+        {
+            int fds[2];
+            REQUIRE(::pipe(fds) == 0);
+            CHECK(bosswestfalen::detail::write_all(fds[1], buffers) == 0);
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+    }
+
+    GIVEN("a string_builder with more strings than writev accepts at once")
+    {
+        bosswestfalen::basic_string_builder<std::deque> sb;
+        std::string expected;
+        for (int i{0}; i < 5000; ++i)
+        {
+            sb.add(i);
+            expected += std::to_string(i);
+        }
+
+        WHEN("the buffers are requested")
+        {
+            auto const buffers = sb.iovecs();
+
+            THEN("there is one buffer per string")
+            {
+                CHECK(buffers.size() == 5000);
+            }
+        }
+
+        WHEN("it is written to a pipe")
+        {
+            THEN("the result of build() is received")
+            {
+                CHECK(expected == through_pipe(sb));
+            }
+        }
+    }
+
+    GIVEN("an empty string_builder")
+    {
+        bosswestfalen::string_builder sb;
+
+        WHEN("it is written to a pipe")
+        {
+            THEN("nothing is received")
+            {
+                CHECK(through_pipe(sb).empty());
+                CHECK(sb.iovecs().empty());
+            }
+        }
+    }
+}